@@ -0,0 +1,67 @@
+#include "graph.h"
+#include "csr_graph.h"
+#include "compressed_graph.h"
+#include "reorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Compares memory use and breadth first search time of the csr and the
+// compressed adjacency of an RCM ordered grid graph with long range links.
+// usage: compressed_bench [side] [runs]
+
+typedef nostd::graph<int, int> graph_type;
+
+template<typename Graph>
+double bfs_time(const Graph& _g, size_t _runs) {
+  std::vector<uint32_t> dist;
+  std::vector<double> times;
+  for(size_t r = 0; r < _runs; ++r) {
+    auto start = std::chrono::steady_clock::now();
+    nostd::breath_first_search(_g, 0, dist);
+    auto stop = std::chrono::steady_clock::now();
+    times.push_back(std::chrono::duration<double, std::milli>(stop - start).count());
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+int main(int argc, char** argv) {
+  size_t side = (argc > 1) ? atoi(argv[1]) : 500;
+  size_t runs = (argc > 2) ? atoi(argv[2]) : 5;
+
+  graph_type g;
+  std::vector<graph_type::vertex*> verts(side * side);
+  for(size_t c = 0; c < verts.size(); ++c)
+    verts[c] = g.insert_vertex(int(c));
+  for(size_t y = 0; y < side; ++y)
+    for(size_t x = 0; x < side; ++x) {
+      size_t c = y * side + x;
+      if(x + 1 < side)
+        g.insert_undirected(verts[c], verts[c + 1], 1);
+      if(y + 1 < side)
+        g.insert_undirected(verts[c], verts[c + side], 1);
+      if(c % 16 == 0)
+        g.insert_edge(verts[c], verts[(c * 7919) % verts.size()], 1);
+    }
+  nostd::reorder(g, nostd::RCM_ORDER);
+
+  nostd::csr_graph<graph_type> csr(g);
+  nostd::compressed_graph<graph_type> packed(csr);
+
+  size_t n = csr.num_vertices(), m = csr.num_edges();
+  size_t csr_bytes = (n + 1) * sizeof(size_t) + m * sizeof(uint32_t);
+  // three set nodes per edge (graph, out list, in list) plus the edge itself
+  size_t set_bytes = m * (3 * 40 + sizeof(graph_type::edge)) +
+                     n * (40 + sizeof(graph_type::vertex));
+
+  std::cout << "vertices " << n << " edges " << m << "\n"
+            << "set graph  ~" << set_bytes / 1024 << " KiB\n"
+            << "csr         " << csr_bytes / 1024 << " KiB  bfs "
+            << bfs_time(csr, runs) << " ms\n"
+            << "compressed  " << packed.memory_bytes() / 1024 << " KiB  bfs "
+            << bfs_time(packed, runs) << " ms\n";
+  return 0;
+}
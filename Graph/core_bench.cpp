@@ -0,0 +1,57 @@
+#include "graph.h"
+#include "core_decomposition.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Core numbers and degree histograms of a random power law like graph:
+// bucket peeling, parallel peeling, and histograms from the adjacency
+// sets against the cached degrees.
+// usage: core_bench [vertices] [degree] [threads]
+
+typedef nostd::graph<int, int> graph_type;
+
+template<typename Func>
+void measure(const char* _name, Func _func) {
+  auto start = std::chrono::steady_clock::now();
+  size_t result = _func();
+  auto stop = std::chrono::steady_clock::now();
+  std::cout << _name << " "
+            << std::chrono::duration<double, std::milli>(stop - start).count()
+            << " ms (" << result << ")\n";
+}
+
+int main(int argc, char** argv) {
+  size_t n = (argc > 1) ? atoi(argv[1]) : 200000;
+  size_t degree = (argc > 2) ? atoi(argv[2]) : 8;
+  size_t threads = (argc > 3) ? atoi(argv[3]) : 4;
+
+  std::mt19937 rng(42);
+  graph_type g;
+  nostd::degree_index<graph_type> degrees(g);
+  std::vector<graph_type::vertex*> verts;
+  for(size_t i = 0; i < n; ++i)
+    verts.push_back(g.insert_vertex(int(i)));
+  // the product of two uniform picks favors low indices
+  for(size_t i = 0; i < n * degree / 2; ++i) {
+    size_t a = size_t(rng() % n) * (rng() % n) / n;
+    g.insert_undirected(verts[a], verts[rng() % n], 1);
+  }
+  std::cout << "vertices " << g.num_vertices() << " edges " << g.num_edges()
+            << " max degree " << degrees.max_degree() << "\n";
+
+  nostd::executor exec(threads);
+  nostd::vertex_property_map<uint32_t> core;
+  measure("core_numbers", [&] { return nostd::core_numbers(g, core, nostd::OUT_DEGREE); });
+  measure("core_numbers cached", [&] {
+    return nostd::core_numbers(degrees, core, nostd::OUT_DEGREE);
+  });
+  measure("parallel_core_numbers", [&] {
+    return nostd::parallel_core_numbers(g, core, &exec, nostd::OUT_DEGREE);
+  });
+  measure("degree_histogram", [&] { return nostd::degree_histogram(g).size(); });
+  measure("degree_index histogram", [&] { return degrees.histogram().size(); });
+  return 0;
+}
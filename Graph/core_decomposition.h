@@ -0,0 +1,364 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @name Core Decomposition
+/// @group Graph Algorithms
+///
+/// @note Degree analytics and k-core decomposition.
+///
+///       degree_index caches the in and out degree of every vertex in
+///       dense arrays. It is a graph::observer, so insert_edge and
+///       erase_edge keep it current in O(1), and degree queries and
+///       histograms read the arrays instead of the adjacency sets.
+///
+///       The core number of a vertex is the largest k such that the
+///       vertex belongs to a subgraph in which every vertex has degree at
+///       least k. Which degree is chosen by a degree_kind:
+///           TOTAL_DEGREE - in + out, every edge counted at both endpoints
+///           OUT_DEGREE   - the out-core; on a graph built with
+///                          insert_undirected this is the usual core
+///                          number of the undirected graph
+///           IN_DEGREE    - the in-core
+///
+///       core_numbers is the O(V + E) bucket algorithm of Batagelj and
+///       Zaversnik: vertices are kept sorted by degree in one array and
+///       peeled lowest first, a neighbor losing a degree moves one bucket
+///       down in O(1).
+///
+///       parallel_core_numbers peels in rounds on an executor. At level k
+///       every remaining vertex of degree at most k is removed at once;
+///       the neighbors whose degree drops to k join the next round. When
+///       a level runs dry the remaining vertices are compacted and k jumps
+///       to their smallest degree.
+///
+///       Self loops count toward the degree but never lower it, so both
+///       algorithms agree on graphs that have them.
+///
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CORE_DECOMPOSITION_H
+#define CORE_DECOMPOSITION_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "../Parallel/executor.h"
+#include "instrument.h"
+#include "property_map.h"
+
+namespace nostd {
+
+  enum degree_kind { TOTAL_DEGREE, OUT_DEGREE, IN_DEGREE };
+
+  /// @return Degree of _vert in _graph, any graph or view
+  template<typename GraphType>
+  size_t degree_of(const GraphType& _graph, typename GraphType::vertex* _vert,
+                   degree_kind _kind) {
+    switch(_kind) {
+      case OUT_DEGREE: return _graph.out_degree(_vert);
+      case IN_DEGREE: return _graph.in_degree(_vert);
+      default: return _graph.out_degree(_vert) + _graph.in_degree(_vert);
+    }
+  }
+
+  /// @return Element d is the number of vertices of degree d
+  template<typename GraphType>
+  std::vector<size_t> degree_histogram(const GraphType& _graph,
+                                       degree_kind _kind = TOTAL_DEGREE) {
+    std::vector<size_t> counts;
+    for(size_t i = 0; i < _graph.num_vertices(); ++i) {
+      auto v = _graph.vertex_at(i);
+      if(!_graph.contains(v))
+        continue;
+      size_t d = degree_of(_graph, v, _kind);
+      if(d >= counts.size())
+        counts.resize(d + 1, 0);
+      ++counts[d];
+    }
+    return counts;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief In and out degrees of every vertex, kept current as the graph
+  ///        changes. The graph must outlive it.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename GraphType>
+  class degree_index : public GraphType::observer {
+    public:
+      typedef typename GraphType::vertex vertex;
+      typedef typename GraphType::edge edge;
+
+      /// @name constructors
+      /// @{
+      degree_index(GraphType& _graph): m_graph(&_graph) {
+        reset();
+        m_graph->attach(this);
+      }
+
+      degree_index(const degree_index&) = delete;
+      degree_index& operator=(const degree_index&) = delete;
+
+      ~degree_index() { m_graph->detach(this); }
+      /// @}
+
+      /// @name Queries
+      /// @{
+      const GraphType& graph() const { return *m_graph; }
+
+      uint32_t out_degree(const vertex* _vert) const { return m_out[_vert]; }
+      uint32_t in_degree(const vertex* _vert) const { return m_in[_vert]; }
+      uint32_t degree(const vertex* _vert) const { return m_out[_vert] + m_in[_vert]; }
+
+      uint32_t degree(size_t _index, degree_kind _kind) const {
+        switch(_kind) {
+          case OUT_DEGREE: return m_out[_index];
+          case IN_DEGREE: return m_in[_index];
+          default: return m_out[_index] + m_in[_index];
+        }
+      }
+
+      const vertex_property_map<uint32_t>& out_degrees() const { return m_out; }
+      const vertex_property_map<uint32_t>& in_degrees() const { return m_in; }
+
+      uint32_t max_degree(degree_kind _kind = TOTAL_DEGREE) const {
+        uint32_t result = 0;
+        for(size_t i = 0; i < m_out.size(); ++i)
+          result = std::max(result, degree(i, _kind));
+        return result;
+      }
+
+      /// @return Element d is the number of vertices of degree d
+      std::vector<size_t> histogram(degree_kind _kind = TOTAL_DEGREE) const {
+        std::vector<size_t> counts(m_out.size() == 0 ? 0 : size_t(max_degree(_kind)) + 1, 0);
+        for(size_t i = 0; i < m_out.size(); ++i)
+          ++counts[degree(i, _kind)];
+        return counts;
+      }
+      /// @}
+
+      /// @name Graph Events
+      /// @{
+      void inserted(vertex*) override {
+        m_out.push_back(0);
+        m_in.push_back(0);
+      }
+
+      void inserted(edge* _edge) override {
+        ++m_out[_edge->source()];
+        ++m_in[_edge->target()];
+      }
+
+      void erasing(edge* _edge) override {
+        --m_out[_edge->source()];
+        --m_in[_edge->target()];
+      }
+
+      // the graph moves its last vertex into the erased one's index
+      void erasing(vertex* _vert) override {
+        m_out.swap_remove(_vert->index());
+        m_in.swap_remove(_vert->index());
+      }
+
+      void reset() override {
+        m_out.reset(*m_graph);
+        m_in.reset(*m_graph);
+        for(size_t i = 0; i < m_graph->num_vertices(); ++i) {
+          m_out[i] = uint32_t(m_graph->vertex_at(i)->out_degree());
+          m_in[i] = uint32_t(m_graph->vertex_at(i)->in_degree());
+        }
+      }
+      /// @}
+
+    private:
+      GraphType* m_graph;
+      vertex_property_map<uint32_t> m_out;
+      vertex_property_map<uint32_t> m_in;
+  };
+
+  /// @brief Calls _func(u) for every edge whose removal with _vert lowers
+  ///        the degree of u: the edges counted in the degree of u.
+  template<typename GraphType, typename Func>
+  void for_each_dependent(const GraphType& _graph, typename GraphType::vertex* _vert,
+                          degree_kind _kind, Func _func) {
+    if(_kind != OUT_DEGREE)
+      for(auto iter = _graph.out_begin(_vert); iter != _graph.out_end(_vert); ++iter)
+        _func(_graph.target(*iter));
+    if(_kind != IN_DEGREE)
+      for(auto iter = _graph.in_begin(_vert); iter != _graph.in_end(_vert); ++iter)
+        _func(_graph.source(*iter));
+  }
+
+  /// @brief Bucket peeling from the degrees in _deg, which it consumes
+  template<typename GraphType>
+  uint32_t bucket_core_numbers(const GraphType& _graph, std::vector<uint32_t>& _deg,
+                               vertex_property_map<uint32_t>& _core, degree_kind _kind) {
+    NOSTD_ALGO_RUN(CORE_DECOMPOSITION);
+    size_t n = _deg.size();
+    uint32_t max_deg = 0;
+    for(auto d : _deg)
+      max_deg = std::max(max_deg, d);
+
+    // vertices sorted by degree; bin[d] is where degree d starts in order
+    std::vector<uint32_t> bin(size_t(max_deg) + 2, 0), pos(n), order(n);
+    for(auto d : _deg)
+      ++bin[d + 1];
+    for(size_t d = 1; d < bin.size(); ++d)
+      bin[d] += bin[d - 1];
+    for(size_t v = 0; v < n; ++v) {
+      pos[v] = bin[_deg[v]]++;
+      order[pos[v]] = uint32_t(v);
+    }
+    for(size_t d = bin.size() - 1; d > 0; --d)
+      bin[d] = bin[d - 1];
+    bin[0] = 0;
+
+    uint32_t max_core = 0;
+    for(size_t i = 0; i < n; ++i) {
+      uint32_t v = order[i];
+      auto vert = _graph.vertex_at(v);
+      if(!_graph.contains(vert))
+        continue;
+      NOSTD_ALGO_VERTICES(1);
+      max_core = std::max(max_core, _deg[v]);
+      for_each_dependent(_graph, vert, _kind, [&](typename GraphType::vertex* _u) {
+        uint32_t u = uint32_t(_u->index());
+        if(_deg[u] <= _deg[v])
+          return;
+        // swap u with the first vertex of its bucket, then shrink the bucket
+        uint32_t first = order[bin[_deg[u]]];
+        if(first != u) {
+          std::swap(order[pos[u]], order[bin[_deg[u]]]);
+          std::swap(pos[u], pos[first]);
+        }
+        ++bin[_deg[u]];
+        --_deg[u];
+      });
+      _core[v] = _deg[v];
+    }
+    return max_core;
+  }
+
+  /// @brief Core numbers in O(V + E).
+  /// @param _core Set to the core number of every vertex; vertices outside
+  ///        a view are left 0.
+  /// @return The largest core number
+  template<typename GraphType>
+  uint32_t core_numbers(const GraphType& _graph, vertex_property_map<uint32_t>& _core,
+                        degree_kind _kind = TOTAL_DEGREE) {
+    std::vector<uint32_t> deg(_graph.num_vertices(), 0);
+    for(size_t i = 0; i < deg.size(); ++i) {
+      auto v = _graph.vertex_at(i);
+      if(_graph.contains(v))
+        deg[i] = uint32_t(degree_of(_graph, v, _kind));
+    }
+    _core.reset(_graph, 0);
+    return bucket_core_numbers(_graph, deg, _core, _kind);
+  }
+
+  /// @brief core_numbers with the starting degrees read from a degree_index
+  template<typename GraphType>
+  uint32_t core_numbers(const degree_index<GraphType>& _degrees,
+                        vertex_property_map<uint32_t>& _core,
+                        degree_kind _kind = TOTAL_DEGREE) {
+    const GraphType& graph = _degrees.graph();
+    std::vector<uint32_t> deg(graph.num_vertices());
+    for(size_t i = 0; i < deg.size(); ++i)
+      deg[i] = _degrees.degree(i, _kind);
+    _core.reset(graph, 0);
+    return bucket_core_numbers(graph, deg, _core, _kind);
+  }
+
+  /// @brief Core numbers by parallel peeling; same results as core_numbers.
+  /// @return The largest core number
+  template<typename GraphType>
+  uint32_t parallel_core_numbers(const GraphType& _graph,
+                                 vertex_property_map<uint32_t>& _core,
+                                 executor* _exec, degree_kind _kind = TOTAL_DEGREE) {
+    NOSTD_ALGO_RUN(CORE_DECOMPOSITION);
+    typedef typename GraphType::vertex vertex;
+    const uint32_t UNSET = std::numeric_limits<uint32_t>::max();
+    const size_t grain = 256;
+    size_t n = _graph.num_vertices();
+    size_t slots = (_exec == nullptr) ? 1 : _exec->num_threads() + 1;
+    auto slot = [&]() { return (_exec == nullptr) ? 0 : _exec->worker_id(); };
+
+    std::unique_ptr<std::atomic<uint32_t>[]> deg(new std::atomic<uint32_t>[n]);
+    std::unique_ptr<std::atomic<uint32_t>[]> core(new std::atomic<uint32_t>[n]);
+    std::vector<std::vector<uint32_t>> found(slots);
+    std::vector<uint32_t> lowest(slots, UNSET);     // smallest degree kept
+    std::vector<uint32_t> remaining, frontier;
+    auto gather = [&](std::vector<uint32_t>& _into) {
+      _into.clear();
+      for(auto& f : found) {
+        _into.insert(_into.end(), f.begin(), f.end());
+        f.clear();
+      }
+    };
+    auto keep = [&](uint32_t _v, uint32_t _deg) {
+      size_t s = slot();
+      found[s].push_back(_v);
+      lowest[s] = std::min(lowest[s], _deg);
+    };
+
+    parallel_for(_exec, 0, n, [&](size_t i) {
+      vertex* v = _graph.vertex_at(i);
+      bool in = _graph.contains(v);
+      uint32_t d = in ? uint32_t(degree_of(_graph, v, _kind)) : 0;
+      deg[i].store(d, std::memory_order_relaxed);
+      core[i].store(in ? UNSET : 0, std::memory_order_relaxed);
+      if(in)
+        keep(uint32_t(i), d);
+    }, grain * 16);
+    gather(remaining);
+
+    uint32_t k = 0;
+    while(!remaining.empty()) {
+      // the level is the smallest remaining degree
+      k = *std::min_element(lowest.begin(), lowest.end());
+      std::fill(lowest.begin(), lowest.end(), UNSET);
+      parallel_for(_exec, 0, remaining.size(), [&](size_t i) {
+        uint32_t v = remaining[i];
+        if(deg[v].load(std::memory_order_relaxed) <= k) {
+          core[v].store(k, std::memory_order_relaxed);
+          found[slot()].push_back(v);
+        }
+      }, grain * 16);
+      gather(frontier);
+
+      // rounds of removal; a neighbor is claimed by the decrement that
+      // takes its degree from k + 1 to k
+      while(!frontier.empty()) {
+        NOSTD_ALGO_FRONTIER(frontier.size());
+        parallel_for(_exec, 0, frontier.size(), [&](size_t i) {
+          NOSTD_ALGO_VERTICES(1);
+          for_each_dependent(_graph, _graph.vertex_at(frontier[i]), _kind, [&](vertex* _u) {
+            uint32_t u = uint32_t(_u->index());
+            if(core[u].load(std::memory_order_relaxed) != UNSET)
+              return;
+            if(deg[u].fetch_sub(1, std::memory_order_relaxed) == k + 1) {
+              core[u].store(k, std::memory_order_relaxed);
+              found[slot()].push_back(u);
+            }
+          });
+        }, grain, DYNAMIC);
+        gather(frontier);
+      }
+
+      parallel_for(_exec, 0, remaining.size(), [&](size_t i) {
+        uint32_t v = remaining[i];
+        if(core[v].load(std::memory_order_relaxed) == UNSET)
+          keep(v, deg[v].load(std::memory_order_relaxed));
+      }, grain * 16);
+      gather(remaining);
+    }
+
+    _core.reset(_graph, 0);
+    parallel_for(_exec, 0, n, [&](size_t i) {
+      _core[i] = core[i].load(std::memory_order_relaxed);
+    }, grain * 16);
+    return k;
+  }
+}
+
+#endif // CORE_DECOMPOSITION_H
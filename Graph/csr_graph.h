@@ -0,0 +1,277 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @name CSR Graph
+/// @group Graph
+///
+/// @note Read only compressed sparse row snapshot of a graph. Vertex ids are
+///       the dense vertex indices of the source graph and every neighbor
+///       list is sorted by id.
+///
+///       The vertex range is split into one partition per NUMA node, with
+///       roughly the same number of edges in each. A partition's offsets
+///       and targets are allocated on its node and first touched by the
+///       workers pinned to that node, and for_each_partition schedules the
+///       work on a partition to those same workers. Without an executor, or
+///       on a single node machine, this is a plain CSR.
+///
+///       A snapshot of a view from graph_view.h keeps the full vertex id
+///       range; vertices outside the view have no neighbors.
+///
+///////////////////////////////////////////////////////////////////////////////
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "../Parallel/executor.h"
+#include "../Parallel/numa_topology.h"
+#include "instrument.h"
+
+namespace nostd {
+
+  template<typename GraphType>
+  class csr_graph {
+    public:
+      /// @name CSR Graph Typedefs
+      /// @{
+      typedef uint32_t vertex_id;
+      typedef typename GraphType::vertex graph_vertex;
+
+      static constexpr vertex_id INVALID_ID = std::numeric_limits<vertex_id>::max();
+
+      class neighbor_range {
+        public:
+          neighbor_range(const vertex_id* _begin, const vertex_id* _end):
+                         m_begin(_begin), m_end(_end) {}
+
+          const vertex_id* begin() const { return m_begin; }
+          const vertex_id* end() const { return m_end; }
+          size_t size() const { return m_end - m_begin; }
+
+        private:
+          const vertex_id* m_begin;
+          const vertex_id* m_end;
+      };
+
+      struct partition {
+        size_t node;                      // logical node running the work
+        vertex_id first;                  // first vertex in the partition
+        vertex_id last;                   // one past the last vertex
+        numa_array<size_t> offsets;       // last - first + 1 local offsets
+        numa_array<vertex_id> targets;    // out neighbors of the range
+      };
+      /// @}
+
+      /// @name constructors
+      /// @{
+
+      /// @param _graph Graph to snapshot; must not change while building.
+      /// @param _exec Builds the partitions on the workers of their nodes.
+      csr_graph(const GraphType& _graph, executor* _exec = nullptr,
+                const numa_topology& _topo = numa_topology::system()) {
+        size_t n = _graph.num_vertices();
+        m_vertices.resize(n);
+        std::vector<size_t> prefix(n + 1, 0);
+        for(size_t i = 0; i < n; ++i) {
+          m_vertices[i] = _graph.vertex_at(i);
+          prefix[i + 1] = prefix[i] + _graph.out_degree(m_vertices[i]);
+        }
+        m_num_edges = prefix[n];
+
+        split(prefix, _topo);
+
+        for_each_partition(_exec, [&](size_t _p, vertex_id _lo, vertex_id _hi) {
+          partition& part = m_parts[_p];
+          size_t base = prefix[part.first];
+          for(vertex_id v = _lo; v < _hi; ++v) {
+            part.offsets[v - part.first] = prefix[v] - base;
+            vertex_id* out = part.targets.data() + (prefix[v] - base);
+            vertex_id* iter = out;
+            for(auto e = _graph.out_begin(m_vertices[v]);
+                e != _graph.out_end(m_vertices[v]);
+                ++e)
+              *iter++ = vertex_id(_graph.target(*e)->index());
+            std::sort(out, iter);
+          }
+          if(_hi == part.last)
+            part.offsets[part.last - part.first] = prefix[part.last] - base;
+        });
+      }
+      /// @}
+
+      /// @name Graph Statistics
+      /// @{
+      size_t num_vertices() const { return m_vertices.size(); }
+      size_t num_edges() const { return m_num_edges; }
+
+      size_t out_degree(vertex_id _v) const {
+        const partition& part = m_parts[partition_of(_v)];
+        size_t local = _v - part.first;
+        return part.offsets[local + 1] - part.offsets[local];
+      }
+      /// @}
+
+      /// @name Vertex Access
+      /// @{
+      neighbor_range neighbors(vertex_id _v) const {
+        const partition& part = m_parts[partition_of(_v)];
+        size_t local = _v - part.first;
+        const vertex_id* base = part.targets.data();
+        return neighbor_range(base + part.offsets[local],
+                              base + part.offsets[local + 1]);
+      }
+
+      /// @return The vertex of the source graph with id _v
+      graph_vertex* source_vertex(vertex_id _v) const { return m_vertices[_v]; }
+
+      vertex_id id(const graph_vertex* _vert) const { return vertex_id(_vert->index()); }
+      /// @}
+
+      /// @name Partitions
+      /// @{
+      size_t num_partitions() const { return m_parts.size(); }
+      const partition& get_partition(size_t _p) const { return m_parts[_p]; }
+
+      size_t partition_of(vertex_id _v) const {
+        return std::upper_bound(m_bounds.begin(), m_bounds.end(), _v) - m_bounds.begin();
+      }
+
+      /// @brief Calls _func(p, lo, hi) over [lo, hi) chunks of every
+      ///        partition p, on the workers of the partition's node.
+      template<typename Func>
+      void for_each_partition(executor* _exec, Func _func,
+                              size_t _grain = 4096) const {
+        task_group group(_exec);
+        for(size_t p = 0; p < m_parts.size(); ++p) {
+          const partition& part = m_parts[p];
+          for(vertex_id lo = part.first; lo < part.last; ) {
+            vertex_id hi = vertex_id(std::min<size_t>(part.last, lo + _grain));
+            group.run_on_node(part.node, [&_func, p, lo, hi] {
+              _func(p, lo, hi);
+            });
+            lo = hi;
+          }
+        }
+        group.wait();
+      }
+      /// @}
+
+    private:
+      // splits the vertices into one range per node of _topo, each holding
+      // about the same number of vertices plus edges
+      void split(const std::vector<size_t>& _prefix, const numa_topology& _topo) {
+        size_t nodes = _topo.num_nodes();
+        size_t n = m_vertices.size();
+        size_t total = n + m_num_edges;
+        vertex_id first = 0;
+        for(size_t p = 0; p < nodes; ++p) {
+          vertex_id last = vertex_id(n);
+          if(p + 1 < nodes) {
+            size_t goal = total * (p + 1) / nodes;
+            last = first;
+            while(last < n && last + _prefix[last] < goal)
+              ++last;
+          }
+          partition part;
+          part.node = p;
+          part.first = first;
+          part.last = last;
+          part.offsets = numa_array<size_t>(last - first + 1, _topo.os_node(p));
+          part.targets = numa_array<vertex_id>(_prefix[last] - _prefix[first],
+                                               _topo.os_node(p));
+          if(first == last)
+            part.offsets[0] = 0;
+          m_parts.push_back(std::move(part));
+          m_bounds.push_back(last);
+          first = last;
+        }
+      }
+
+      std::vector<graph_vertex*> m_vertices;      // source vertex of every id
+      std::vector<partition> m_parts;
+      std::vector<vertex_id> m_bounds;            // last of every partition
+      size_t m_num_edges;
+  };
+
+  /// @brief Level synchronous breadth first search over a csr_graph.
+  ///        Each level's frontier is kept per partition and expanded on the
+  ///        workers of the partition's node.
+  /// @param _dist Set to the number of hops from _root, or INVALID_ID for
+  ///        unreachable vertices.
+  template<typename GraphType>
+  void breath_first_search(const csr_graph<GraphType>& _graph,
+                           typename csr_graph<GraphType>::vertex_id _root,
+                           std::vector<uint32_t>& _dist,
+                           executor* _exec = nullptr) {
+    typedef typename csr_graph<GraphType>::vertex_id vertex_id;
+    NOSTD_ALGO_RUN(BFS);
+
+    size_t n = _graph.num_vertices();
+    size_t parts = _graph.num_partitions();
+    size_t slots = (_exec == nullptr) ? 1 : _exec->num_threads() + 1;
+    const size_t grain = 1024;
+
+    _dist.assign(n, csr_graph<GraphType>::INVALID_ID);
+    std::vector<std::atomic<uint64_t>> visited((n + 63) / 64);
+    for(auto& w : visited)
+      w.store(0, std::memory_order_relaxed);
+
+    std::vector<std::vector<vertex_id>> frontier(parts);
+    std::vector<std::vector<std::vector<vertex_id>>> next(slots,
+        std::vector<std::vector<vertex_id>>(parts));
+
+    visited[_root / 64].store(uint64_t(1) << (_root % 64));
+    _dist[_root] = 0;
+    frontier[_graph.partition_of(_root)].push_back(_root);
+
+    for(uint32_t level = 1; ; ++level) {
+      auto expand = [&](size_t _p, size_t _lo, size_t _hi) {
+        auto& local = next[(_exec == nullptr) ? 0 : _exec->worker_id()];
+        NOSTD_ALGO_LOCAL_EDGES();
+        for(size_t i = _lo; i < _hi; ++i) {
+          NOSTD_ALGO_ADD_EDGES(_graph.out_degree(frontier[_p][i]));
+          for(vertex_id w : _graph.neighbors(frontier[_p][i])) {
+            uint64_t bit = uint64_t(1) << (w % 64);
+            if(visited[w / 64].load(std::memory_order_relaxed) & bit)
+              continue;
+            if(visited[w / 64].fetch_or(bit) & bit)
+              continue;
+            _dist[w] = level;
+            local[_graph.partition_of(w)].push_back(w);
+          }
+        }
+      };
+
+      {
+        task_group group(_exec);
+        for(size_t p = 0; p < parts; ++p) {
+          NOSTD_ALGO_FRONTIER(frontier[p].size());
+          NOSTD_ALGO_VERTICES(frontier[p].size());
+          size_t node = _graph.get_partition(p).node;
+          for(size_t lo = 0; lo < frontier[p].size(); lo += grain) {
+            size_t hi = std::min(frontier[p].size(), lo + grain);
+            group.run_on_node(node, [&expand, p, lo, hi] { expand(p, lo, hi); });
+          }
+        }
+        group.wait();
+      }
+
+      bool empty = true;
+      for(size_t p = 0; p < parts; ++p) {
+        frontier[p].clear();
+        for(auto& slot : next) {
+          frontier[p].insert(frontier[p].end(), slot[p].begin(), slot[p].end());
+          slot[p].clear();
+        }
+        empty = empty && frontier[p].empty();
+      }
+      if(empty)
+        break;
+    }
+  }
+}
+
+#endif // CSR_GRAPH_H
@@ -0,0 +1,398 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @name Dynamic Algorithms
+/// @group Graph Algorithms
+///
+/// @note Answers kept up to date while a graph changes, instead of being
+///       recomputed after every batch of changes. Each structure attaches
+///       itself to the graph as a graph::observer on construction and
+///       detaches on destruction; the graph must outlive it.
+///
+///           dynamic_connectivity   - weakly connected components
+///           dynamic_shortest_paths - distances from one source
+///           dynamic_bfs            - hop counts from one source
+///
+///       dynamic_connectivity merges components in a union_find as edges
+///       are inserted. Erasing an edge that has a parallel edge, in either
+///       direction, or erasing a self loop changes nothing; any other
+///       erase marks the components stale and the next query rebuilds
+///       them, so a batch of erases costs one rebuild.
+///
+///       dynamic_shortest_paths records the edges inserted and erased and
+///       repairs the distances on the next query, or on update():
+///         1. vertices that lost every shortest path through an erased
+///            edge are found in order of their old distance
+///         2. those vertices take the best distance offered by their
+///            remaining in edges, the targets of inserted edges take the
+///            distance through the new edge, and a Dijkstra search from
+///            them settles everything that changed.
+///       The work is proportional to the vertices whose distance changed
+///       and their edges; touched() reports it for the last update. Edge
+///       weights must be positive and must not change while an edge is in
+///       the graph; erase and insert the edge to change its weight.
+///
+///       Erasing a vertex, clear(), relabel() and swapping the graph move
+///       vertex indices, so they make either structure rebuild on its
+///       next query.
+///
+///////////////////////////////////////////////////////////////////////////////
+#ifndef DYNAMIC_ALGORITHM_H
+#define DYNAMIC_ALGORITHM_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../Parallel/executor.h"
+#include "../Parallel/union_find.h"
+#include "property_map.h"
+
+namespace nostd {
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief Weakly connected components of a graph under changes.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename GraphType>
+  class dynamic_connectivity : public GraphType::observer {
+    public:
+      typedef typename GraphType::vertex vertex;
+      typedef typename GraphType::edge edge;
+
+      /// @name constructors
+      /// @{
+
+      /// @param _exec Runs the rebuilds, may be null
+      dynamic_connectivity(GraphType& _graph, executor* _exec = nullptr):
+                           m_graph(&_graph), m_exec(_exec) {
+        rebuild();
+        m_graph->attach(this);
+      }
+
+      dynamic_connectivity(const dynamic_connectivity&) = delete;
+      dynamic_connectivity& operator=(const dynamic_connectivity&) = delete;
+
+      ~dynamic_connectivity() { m_graph->detach(this); }
+      /// @}
+
+      /// @name Queries
+      /// @{
+      bool connected(const vertex* _a, const vertex* _b) {
+        refresh();
+        return m_sets.same(uint32_t(_a->index()), uint32_t(_b->index()));
+      }
+
+      /// @return Index of the representative of _vert's component; valid
+      ///         until the graph changes
+      size_t component(const vertex* _vert) {
+        refresh();
+        return m_sets.find(uint32_t(_vert->index()));
+      }
+
+      size_t num_components() {
+        refresh();
+        return m_components;
+      }
+
+      /// @return Times the components were computed from scratch
+      size_t rebuilds() const { return m_rebuilds; }
+      /// @}
+
+      /// @name Graph Events
+      /// @{
+      void inserted(vertex*) override {
+        if(!m_stale) {
+          m_sets.grow(m_graph->num_vertices());
+          ++m_components;
+        }
+      }
+
+      void inserted(edge* _edge) override {
+        if(!m_stale && m_sets.unite(uint32_t(_edge->source()->index()),
+                                    uint32_t(_edge->target()->index())))
+          --m_components;
+      }
+
+      void erasing(edge* _edge) override {
+        if(!m_stale && _edge->source() != _edge->target() && !parallel(_edge))
+          m_stale = true;
+      }
+
+      void erasing(vertex*) override { m_stale = true; }
+      void reset() override { m_stale = true; }
+      /// @}
+
+    private:
+      void refresh() {
+        if(m_stale)
+          rebuild();
+      }
+
+      void rebuild() {
+        size_t n = m_graph->num_vertices();
+        m_sets.reset(n);
+        std::atomic<size_t> merged(0);
+        parallel_for(m_exec, 0, m_graph->num_edges(), [&](size_t i) {
+          edge* e = m_graph->edge_at(i);
+          if(m_sets.unite(uint32_t(e->source()->index()), uint32_t(e->target()->index())))
+            merged.fetch_add(1, std::memory_order_relaxed);
+        }, 4096);
+        m_components = n - merged.load();
+        m_stale = false;
+        ++m_rebuilds;
+      }
+
+      // whether another edge joins the endpoints of _edge; scans the
+      // endpoint with fewer edges
+      bool parallel(edge* _edge) const {
+        vertex* near = _edge->source();
+        vertex* far = _edge->target();
+        if(near->out_degree() + near->in_degree() > far->out_degree() + far->in_degree())
+          std::swap(near, far);
+        for(auto iter = m_graph->out_begin(near); iter != m_graph->out_end(near); ++iter)
+          if(*iter != _edge && (*iter)->target() == far)
+            return true;
+        for(auto iter = m_graph->in_begin(near); iter != m_graph->in_end(near); ++iter)
+          if(*iter != _edge && (*iter)->source() == far)
+            return true;
+        return false;
+      }
+
+      GraphType* m_graph;
+      executor* m_exec;
+      union_find m_sets;
+      size_t m_components{0};
+      size_t m_rebuilds{0};
+      bool m_stale{false};
+  };
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief Shortest path distances from a source under changes.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename GraphType, typename WeightFunc = edge_weight>
+  class dynamic_shortest_paths : public GraphType::observer {
+    public:
+      typedef typename GraphType::vertex vertex;
+      typedef typename GraphType::edge edge;
+      typedef std::decay_t<decltype(std::declval<WeightFunc>()(std::declval<edge*>()))>
+          distance_type;
+
+      /// @name constructors
+      /// @{
+      dynamic_shortest_paths(GraphType& _graph, vertex* _source,
+                             WeightFunc _weight = WeightFunc()):
+                             m_graph(&_graph), m_source(_source), m_weight(_weight) {
+        rebuild();
+        m_graph->attach(this);
+      }
+
+      dynamic_shortest_paths(const dynamic_shortest_paths&) = delete;
+      dynamic_shortest_paths& operator=(const dynamic_shortest_paths&) = delete;
+
+      ~dynamic_shortest_paths() { m_graph->detach(this); }
+      /// @}
+
+      /// @name Queries
+      /// @{
+      static distance_type infinity() { return std::numeric_limits<distance_type>::max(); }
+
+      /// @return Distance from the source, infinity() when unreachable
+      distance_type distance(const vertex* _vert) {
+        update();
+        return m_dist[_vert];
+      }
+
+      const vertex_property_map<distance_type>& distances() {
+        update();
+        return m_dist;
+      }
+
+      /// @return The source, null once it was erased
+      vertex* source() const { return m_source; }
+
+      /// @brief Repairs the distances for the changes since the last update
+      void update() {
+        if(m_stale)
+          rebuild();
+        else if(!m_erased.empty() || !m_inserted.empty())
+          repair();
+      }
+
+      /// @return Vertices settled or checked by the last update
+      size_t touched() const { return m_touched; }
+
+      /// @return Times the distances were computed from scratch
+      size_t rebuilds() const { return m_rebuilds; }
+      /// @}
+
+      /// @name Graph Events
+      /// @{
+      void inserted(vertex*) override {
+        if(!m_stale) {
+          m_dist.push_back(infinity());
+          m_state.push_back(UNTOUCHED);
+        }
+      }
+
+      void inserted(edge* _edge) override {
+        if(!m_stale)
+          m_inserted.insert(_edge);
+      }
+
+      // an edge inserted since the last update never carried a distance
+      void erasing(edge* _edge) override {
+        if(m_stale || m_inserted.erase(_edge) != 0)
+          return;
+        m_erased.push_back({uint32_t(_edge->source()->index()),
+                            uint32_t(_edge->target()->index()), m_weight(_edge)});
+      }
+
+      void erasing(vertex* _vert) override {
+        if(_vert == m_source)
+          m_source = nullptr;
+        m_stale = true;
+      }
+
+      void reset() override {
+        if(m_source != nullptr && m_graph->find_vertex(m_source) == m_graph->end())
+          m_source = nullptr;
+        m_stale = true;
+      }
+      /// @}
+
+    private:
+      enum state { UNTOUCHED, SUPPORTED, AFFECTED };
+
+      struct erased_edge {
+        uint32_t source;
+        uint32_t target;
+        distance_type weight;
+      };
+
+      typedef std::pair<distance_type, uint32_t> entry;
+      typedef std::priority_queue<entry, std::vector<entry>, std::greater<entry>> heap_type;
+
+      void rebuild() {
+        m_dist.reset(*m_graph, infinity());
+        m_state.reset(*m_graph, UNTOUCHED);
+        m_inserted.clear();
+        m_erased.clear();
+        m_touched = 0;
+        if(m_source != nullptr) {
+          m_dist[m_source] = 0;
+          m_heap.push(entry(0, uint32_t(m_source->index())));
+          settle();
+        }
+        m_stale = false;
+        ++m_rebuilds;
+      }
+
+      void repair() {
+        m_touched = 0;
+        std::vector<uint32_t> changed;
+
+        // 1. by old distance, so every in neighbor closer to the source
+        //    already knows whether it is affected
+        for(auto& e : m_erased)
+          if(m_dist[e.source] != infinity() && m_dist[e.source] + e.weight == m_dist[e.target])
+            m_heap.push(entry(m_dist[e.target], e.target));
+        while(!m_heap.empty()) {
+          uint32_t x = m_heap.top().second;
+          m_heap.pop();
+          if(m_state[x] != UNTOUCHED || m_graph->vertex_at(x) == m_source)
+            continue;
+          ++m_touched;
+          changed.push_back(x);
+          vertex* vert = m_graph->vertex_at(x);
+          m_state[x] = supported(vert) ? SUPPORTED : AFFECTED;
+          if(m_state[x] == SUPPORTED)
+            continue;
+          for(auto iter = m_graph->out_begin(vert); iter != m_graph->out_end(vert); ++iter) {
+            vertex* target = (*iter)->target();
+            if(m_state[target] == UNTOUCHED && m_dist[x] + m_weight(*iter) == m_dist[target])
+              m_heap.push(entry(m_dist[target], uint32_t(target->index())));
+          }
+        }
+
+        // 2. best remaining in edge of the affected vertices, then the
+        //    inserted edges, then settle
+        for(auto x : changed)
+          if(m_state[x] == AFFECTED)
+            m_dist[x] = infinity();
+        for(auto x : changed) {
+          if(m_state[x] == AFFECTED) {
+            vertex* vert = m_graph->vertex_at(x);
+            for(auto iter = m_graph->in_begin(vert); iter != m_graph->in_end(vert); ++iter)
+              relax(*iter);
+          }
+          m_state[x] = UNTOUCHED;
+        }
+        for(auto e : m_inserted)
+          relax(e);
+        settle();
+
+        m_inserted.clear();
+        m_erased.clear();
+      }
+
+      // whether an in edge from an unaffected vertex still gives _vert its
+      // distance
+      bool supported(vertex* _vert) {
+        for(auto iter = m_graph->in_begin(_vert); iter != m_graph->in_end(_vert); ++iter) {
+          vertex* source = (*iter)->source();
+          if(m_state[source] != AFFECTED && m_dist[source] != infinity() &&
+             m_dist[source] + m_weight(*iter) == m_dist[_vert])
+            return true;
+        }
+        return false;
+      }
+
+      void relax(edge* _edge) {
+        distance_type d = m_dist[_edge->source()];
+        if(d == infinity())
+          return;
+        d += m_weight(_edge);
+        vertex* target = _edge->target();
+        if(d < m_dist[target]) {
+          m_dist[target] = d;
+          m_heap.push(entry(d, uint32_t(target->index())));
+        }
+      }
+
+      // Dijkstra from the vertices on the heap; stale entries are skipped
+      void settle() {
+        while(!m_heap.empty()) {
+          entry top = m_heap.top();
+          m_heap.pop();
+          if(top.first != m_dist[top.second])
+            continue;
+          ++m_touched;
+          vertex* vert = m_graph->vertex_at(top.second);
+          for(auto iter = m_graph->out_begin(vert); iter != m_graph->out_end(vert); ++iter)
+            relax(*iter);
+        }
+      }
+
+      GraphType* m_graph;
+      vertex* m_source;
+      WeightFunc m_weight;
+      vertex_property_map<distance_type> m_dist;
+      vertex_property_map<char> m_state;
+      heap_type m_heap;
+      std::unordered_set<edge*> m_inserted;     // since the last update
+      std::vector<erased_edge> m_erased;        // since the last update
+      size_t m_touched{0};
+      size_t m_rebuilds{0};
+      bool m_stale{false};
+  };
+
+  /// @brief Hop counts from a source under changes
+  template<typename GraphType>
+  using dynamic_bfs = dynamic_shortest_paths<GraphType, unit_weight>;
+}
+
+#endif // DYNAMIC_ALGORITHM_H
@@ -0,0 +1,76 @@
+#include "graph.h"
+#include "dynamic_algorithm.h"
+#include "shortest_path.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Batches of random edge inserts and erases on a road like grid: repairing
+// the distances and components against recomputing them.
+// usage: dynamic_bench [side] [batches] [batch size]
+
+typedef nostd::graph<int, unsigned> graph_type;
+typedef graph_type::vertex vertex;
+
+int main(int argc, char** argv) {
+  size_t side = (argc > 1) ? atoi(argv[1]) : 300;
+  size_t batches = (argc > 2) ? atoi(argv[2]) : 50;
+  size_t size = (argc > 3) ? atoi(argv[3]) : 10;
+
+  std::mt19937 rng(42);
+  graph_type g;
+  std::vector<vertex*> verts;
+  for(size_t i = 0; i < side * side; ++i)
+    verts.push_back(g.insert_vertex(int(i)));
+  for(size_t y = 0; y < side; ++y)
+    for(size_t x = 0; x < side; ++x) {
+      size_t c = y * side + x;
+      if(x + 1 < side)
+        g.insert_undirected(verts[c], verts[c + 1], 10 + rng() % 90);
+      if(y + 1 < side)
+        g.insert_undirected(verts[c], verts[c + side], 10 + rng() % 90);
+    }
+  std::cout << "vertices " << g.num_vertices() << " edges " << g.num_edges() << "\n";
+
+  nostd::dynamic_shortest_paths<graph_type> paths(g, verts[0]);
+  nostd::dynamic_connectivity<graph_type> components(g);
+  nostd::path_workspace<graph_type> full;
+  double repair_ms = 0, recompute_ms = 0;
+  size_t touched = 0;
+  unsigned long check = 0;
+
+  for(size_t b = 0; b < batches; ++b) {
+    for(size_t i = 0; i < size; ++i) {
+      g.erase_edge(g.edge_at(rng() % g.num_edges()));
+      g.insert_edge(verts[rng() % verts.size()], verts[rng() % verts.size()],
+                    10 + rng() % 90);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    paths.update();
+    check += components.num_components();
+    auto stop = std::chrono::steady_clock::now();
+    repair_ms += std::chrono::duration<double, std::milli>(stop - start).count();
+    touched += paths.touched();
+
+    start = std::chrono::steady_clock::now();
+    nostd::dijkstra_search(g, verts[0], (vertex*)nullptr, full);
+    nostd::union_find sets(g.num_vertices());
+    for(size_t i = 0; i < g.num_edges(); ++i)
+      sets.unite(g.edge_at(i)->source()->index(), g.edge_at(i)->target()->index());
+    stop = std::chrono::steady_clock::now();
+    recompute_ms += std::chrono::duration<double, std::milli>(stop - start).count();
+
+    for(size_t i = 0; i < verts.size(); i += 97)
+      check += (paths.distance(verts[i]) == full.forward.distance(verts[i]));
+  }
+
+  std::cout << "repair " << repair_ms / batches << " ms/batch, touched "
+            << touched / batches << " (" << components.rebuilds()
+            << " component rebuilds)\n"
+            << "recompute " << recompute_ms / batches << " ms/batch\n"
+            << "check " << check << "\n";
+  return 0;
+}
@@ -11,13 +11,34 @@
 ///       All of the algorithms interfaces are the same; however, instead of
 ///       taking a vertex or edge pointer a descriptor is taken.
 ///
+///       Every vertex also carries a dense index in [0, num_vertices()) and
+///       every edge one in [0, num_edges()). Erasing moves the vertex or
+///       edge with the largest index into the hole, so indices are only
+///       stable while nothing is erased. The indices key the dense property
+///       maps in property_map.h.
+///
+///       The graph owns its vertices and edges. Copying a graph copies every
+///       property; moving one only swaps the containers, so vertex and edge
+///       pointers taken from the source stay valid in the destination.
+///       emplace_vertex and emplace_edge construct properties in place.
+///
+///       Structures kept up to date as the graph changes, like those in
+///       dynamic_algorithm.h, derive from graph::observer and attach() to
+///       the graph. Every mutation then calls them; with nothing attached
+///       a mutation only pays for checking an empty list. Observers are not
+///       copied with the graph. Not available with DESCRIPTOR_GRAPH.
+///
 ///////////////////////////////////////////////////////////////////////////////
 #ifndef GRAPH_H
 #define GRAPH_H
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <set>
 #include <utility>
+#include <vector>
+
+#include "instrument.h"
 
 namespace nostd {
 
@@ -30,19 +51,52 @@ namespace nostd {
       /////////////////////////////////////////////////////////////////////////
       /// @name Graph Typedefs
       /// @{
-      typedef typename std::set<vertex*>::iterator vertex_iterator;
-      typedef typename std::set<edge*>::iterator edge_iterator;    
+#ifdef DESCRIPTOR_GRAPH
+      typedef size_t vertex_descriptor;
+      typedef std::pair<vertex_descriptor, vertex_descriptor> edge_descriptor;
+      static const vertex_descriptor INVALID_VERTEX = size_t(-1);
+
+      // order by descriptor so lookups need no temporary vertex or edge
+      struct vertex_less {
+        typedef void is_transparent;
+        bool operator()(const vertex* _a, const vertex* _b) const {
+          return _a->descriptor() < _b->descriptor();
+        }
+        bool operator()(const vertex* _a, vertex_descriptor _b) const {
+          return _a->descriptor() < _b;
+        }
+        bool operator()(vertex_descriptor _a, const vertex* _b) const {
+          return _a < _b->descriptor();
+        }
+      };
+
+      struct edge_less {
+        typedef void is_transparent;
+        bool operator()(const edge* _a, const edge* _b) const {
+          return _a->descriptor() < _b->descriptor();
+        }
+        bool operator()(const edge* _a, const edge_descriptor& _b) const {
+          return _a->descriptor() < _b;
+        }
+        bool operator()(const edge_descriptor& _a, const edge* _b) const {
+          return _a < _b->descriptor();
+        }
+      };
+#else
+      typedef std::less<vertex*> vertex_less;
+      typedef std::less<edge*> edge_less;
+#endif
+
+      typedef typename std::set<vertex*, vertex_less>::iterator vertex_iterator;
+      typedef typename std::set<edge*, edge_less>::iterator edge_iterator;
       
-      typedef typename std::set<vertex*>::const_iterator const_vertex_iterator;
-      typedef typename std::set<edge*>::const_iterator const_edge_iterator;    
+      typedef typename std::set<vertex*, vertex_less>::const_iterator const_vertex_iterator;
+      typedef typename std::set<edge*, edge_less>::const_iterator const_edge_iterator;
 
       typedef VertProp vertex_type;
       typedef EdgeProp edge_type;
 
 #ifdef DESCRIPTOR_GRAPH
-      typedef size_t vertex_descriptor;
-      typedef std::pair<vertex_descriptor, vertex_descriptor> edge_descriptor;
-      static const vertex_descriptor INVALID_VERTEX = size_t(-1);
 
       static inline vertex_descriptor get_opposite(edge_descriptor _edge, 
                                             vertex_descriptor _vert) {
@@ -70,29 +124,58 @@ namespace nostd {
       graph() {}
 #endif
 
+      /// @brief Deep copy; every vertex and edge keeps its index.
+      graph(const graph& _other): graph() { copy(_other); }
+
+      /// @brief Takes the vertices and edges of _other in O(1), leaving
+      ///        _other empty.
+      graph(graph&& _other) noexcept: graph() { swap(_other); }
+
+      /// @brief Copy or move assignment, depending on how _other was built.
+      graph& operator=(graph _other) {
+        swap(_other);
+        return *this;
+      }
+
+      ~graph() { release(); }
+
+      /// @brief Swaps the contents; the observers stay with their graph and
+      ///        are told to reset.
+      void swap(graph& _other) noexcept {
+#ifdef DESCRIPTOR_GRAPH
+        std::swap(m_count, _other.m_count);
+#endif
+        m_vertex.swap(_other.m_vertex);
+        m_edge.swap(_other.m_edge);
+        m_index.swap(_other.m_index);
+        m_edge_index.swap(_other.m_edge_index);
+        notify_reset();
+        _other.notify_reset();
+      }
+
       /// @}
       /// @name Graph Manipulation
       /// @{
 #ifdef DESCRIPTOR_GRAPH
       vertex_iterator find_vertex(vertex_descriptor _vert) {
-        vertex temp = vertex(VertProp(), _vert);
-        return m_vertex.find(&temp);
+        NOSTD_TIME_OP(FIND_VERTEX);
+        return m_vertex.find(_vert);
       }
 
       const_vertex_iterator find_vertex(vertex_descriptor _vert) const {
-        vertex temp = vertex(VertProp(), _vert);
-        return m_vertex.find(&temp);
+        NOSTD_TIME_OP(FIND_VERTEX);
+        return m_vertex.find(_vert);
       }
 
       edge_iterator find_edge(vertex_descriptor _source, vertex_descriptor _target) {
-        edge temp = edge(_source, _target, EdgeProp());
-        return m_edge.find(&temp);
+        NOSTD_TIME_OP(FIND_EDGE);
+        return m_edge.find(std::make_pair(_source, _target));
       }
 
       const_edge_iterator find_edge(vertex_descriptor _source,
                                     vertex_descriptor _target) const {
-        edge temp = edge(_source, _target, EdgeProp());
-        return m_edge.find(&temp);
+        NOSTD_TIME_OP(FIND_EDGE);
+        return m_edge.find(std::make_pair(_source, _target));
       }
 
       edge_iterator find_edge(edge_descriptor _edge) {
@@ -103,25 +186,62 @@ namespace nostd {
         return find_edge(_edge.first, _edge.second);
       }
 
-      vertex_descriptor insert_vertex(const VertProp& _prop) {
-        vertex* temp = new vertex(_prop, m_count);
+      /// @brief Constructs the property of a new vertex from _args
+      template<typename... Args>
+      vertex_descriptor emplace_vertex(Args&&... _args) {
+        NOSTD_TIME_OP(INSERT_VERTEX);
+        vertex* temp = new vertex(std::in_place, std::forward<Args>(_args)...);
+        temp->m_descriptor = m_count;
         m_vertex.insert(temp);
+        add_index(temp);
         return m_count++;
       }
 
-      edge_descriptor insert_edge(vertex_descriptor _source,
-                                  vertex_descriptor _target, 
-                                  const EdgeProp& _prop) {
+      vertex_descriptor insert_vertex(const VertProp& _prop) {
+        return emplace_vertex(_prop);
+      }
+
+      vertex_descriptor insert_vertex(VertProp&& _prop) {
+        return emplace_vertex(std::move(_prop));
+      }
+
+      /// @brief Constructs the property of a new edge from _args. Edges
+      ///        are keyed by their endpoints, so when _source already has an
+      ///        edge to _target nothing is inserted and that edge's
+      ///        descriptor is returned.
+      template<typename... Args>
+      edge_descriptor emplace_edge(vertex_descriptor _source,
+                                   vertex_descriptor _target,
+                                   Args&&... _args) {
+        NOSTD_TIME_OP(INSERT_EDGE);
         auto source = find_vertex(_source);
         auto target = find_vertex(_target);
 
-        edge* temp = new edge(_source, _target, _prop);
-        this->m_edge.insert(temp);
+        edge* temp = new edge(_source, _target, std::in_place,
+                              std::forward<Args>(_args)...);
+        auto inserted = this->m_edge.insert(temp);
+        if(!inserted.second) {
+          delete temp;
+          return (*inserted.first)->descriptor();
+        }
+        add_edge_index(temp);
         (*source)->add_outedge(temp->descriptor());
         (*target)->add_inedge(temp->descriptor());
         return temp->descriptor();
       }
 
+      edge_descriptor insert_edge(vertex_descriptor _source,
+                                  vertex_descriptor _target, 
+                                  const EdgeProp& _prop) {
+        return emplace_edge(_source, _target, _prop);
+      }
+
+      edge_descriptor insert_edge(vertex_descriptor _source,
+                                  vertex_descriptor _target,
+                                  EdgeProp&& _prop) {
+        return emplace_edge(_source, _target, std::move(_prop));
+      }
+
       void insert_undirected(vertex_descriptor _source,
                              vertex_descriptor _target, 
                              const EdgeProp& _prop) {
@@ -129,123 +249,181 @@ namespace nostd {
         insert_edge(_source, _target, _prop);
         insert_edge(_target, _source, _prop);
       }
+
+      void insert_undirected(vertex_descriptor _source,
+                             vertex_descriptor _target,
+                             EdgeProp&& _prop) {
+        insert_edge(_source, _target, _prop);
+        insert_edge(_target, _source, std::move(_prop));
+      }
       
       void erase_vertex(vertex_descriptor _vert) {
-        auto vert = find_vertex(_vert);
-        auto in_iter  = (*vert)->in_begin();
-        auto out_iter = (*vert)->out_begin();
-
-        for(; in_iter != (*vert)->in_end(); ++in_iter) {
-          auto iter = find_edge(*in_iter);
-          (*iter)->source()->remove_edge(*in_iter);
-          m_edge.erase(*in_iter);
-        }
+        NOSTD_TIME_OP(ERASE_VERTEX);
+        auto iter = find_vertex(_vert);
+        vertex* vert = *iter;
+
+        // self loops are in both lists, they are dropped with the out edges
+        for(auto& e : vert->m_inedgelist)
+          if(e.first != _vert) {
+            (*find_vertex(e.first))->m_outedgelist.erase(e);
+            drop_edge(*find_edge(e));
+          }
 
-        for(;out_iter != (*vert)->out_end(); ++out_iter) {
-          auto iter = find_edge(*out_iter);
-          (*iter)->target()->remove_edge(*out_iter);
-          m_edge.erase(*out_iter);
+        for(auto& e : vert->m_outedgelist) {
+          if(e.second != _vert)
+            (*find_vertex(e.second))->m_inedgelist.erase(e);
+          drop_edge(*find_edge(e));
         }
-        m_vertex.erase(vert);
+        remove_index(vert);
+        m_vertex.erase(iter);
+        delete vert;
       }
       
       void erase_edge(edge_descriptor _edge) {
+        NOSTD_TIME_OP(ERASE_EDGE);
         auto source = find_vertex(_edge.first);
         auto target = find_vertex(_edge.second);
 
         (*source)->remove_edge(_edge);
         (*target)->remove_edge(_edge);
-        
-        m_edge.erase(find_edge(_edge));
+
+        drop_edge(*find_edge(_edge));
       }
 
 #else 
       vertex_iterator find_vertex(vertex* _vert) {
+        NOSTD_TIME_OP(FIND_VERTEX);
         return m_vertex.find(_vert);
       }
 
       const_vertex_iterator find_vertex(vertex* _vert) const {
+        NOSTD_TIME_OP(FIND_VERTEX);
         return m_vertex.find(_vert);
       }
 
+      /// @return An edge from _source to _target, or end of the edges
       edge_iterator find_edge(vertex* _source, vertex* _target) {
-        edge temp = edge(_source, _target, EdgeProp());
-        return m_edge.find(&temp);
+        NOSTD_TIME_OP(FIND_EDGE);
+        edge* e = connecting(_source, _target);
+        return (e == nullptr) ? m_edge.end() : m_edge.find(e);
       }
 
       const_edge_iterator find_edge(vertex* _source, vertex* _target) const {
-        edge temp = edge(_source, _target, EdgeProp());
-        return m_edge.find(&temp);
+        NOSTD_TIME_OP(FIND_EDGE);
+        edge* e = connecting(_source, _target);
+        return (e == nullptr) ? m_edge.end() : m_edge.find(e);
       }
 
       edge_iterator find_edge(edge* _edge) {
+        NOSTD_TIME_OP(FIND_EDGE);
         return this->m_edge.find(_edge);
       }
       
       const_edge_iterator find_edge(edge* _edge) const {
+        NOSTD_TIME_OP(FIND_EDGE);
         return this->m_edge.find(_edge);
       }
 
-      vertex* insert_vertex(const VertProp& _prop) {
-        vertex* temp = new vertex(_prop);
+      /// @brief Constructs the property of a new vertex from _args
+      template<typename... Args>
+      vertex* emplace_vertex(Args&&... _args) {
+        NOSTD_TIME_OP(INSERT_VERTEX);
+        vertex* temp = new vertex(std::in_place, std::forward<Args>(_args)...);
         this->m_vertex.insert(temp);
+        add_index(temp);
+        for(auto o : m_observers)
+          o->inserted(temp);
         return temp;
       }
 
-      edge* insert_edge(vertex* _source, vertex* _target, 
-          const EdgeProp& _prop) {
+      vertex* insert_vertex(const VertProp& _prop) {
+        return emplace_vertex(_prop);
+      }
+
+      vertex* insert_vertex(VertProp&& _prop) {
+        return emplace_vertex(std::move(_prop));
+      }
+
+      /// @brief Constructs the property of a new edge from _args
+      template<typename... Args>
+      edge* emplace_edge(vertex* _source, vertex* _target, Args&&... _args) {
+        NOSTD_TIME_OP(INSERT_EDGE);
 
-        edge* temp = new edge(_source, _target, _prop);
+        edge* temp = new edge(_source, _target, std::in_place,
+                              std::forward<Args>(_args)...);
         this->m_edge.insert(temp);
+        add_edge_index(temp);
         _source->add_outedge(temp);
         _target->add_inedge(temp);
+        for(auto o : m_observers)
+          o->inserted(temp);
         return temp;
       }
 
+      edge* insert_edge(vertex* _source, vertex* _target, 
+          const EdgeProp& _prop) {
+        return emplace_edge(_source, _target, _prop);
+      }
+
+      edge* insert_edge(vertex* _source, vertex* _target, EdgeProp&& _prop) {
+        return emplace_edge(_source, _target, std::move(_prop));
+      }
+
       void insert_undirected(vertex* _source, vertex* _target, 
           const EdgeProp& _prop) {
         insert_edge(_source, _target, _prop);
         insert_edge(_target, _source, _prop);
       }
+
+      void insert_undirected(vertex* _source, vertex* _target,
+          EdgeProp&& _prop) {
+        insert_edge(_source, _target, _prop);
+        insert_edge(_target, _source, std::move(_prop));
+      }
       
       void erase_vertex(vertex* _vert) {
-        auto in_iter = _vert->in_begin();
-        auto out_iter = _vert->out_begin();
-        for(; in_iter != _vert->in_end(); ++in_iter) {
-          (*in_iter)->source()->remove_edge(*in_iter);
-          m_edge.erase(*in_iter);
-        }
+        NOSTD_TIME_OP(ERASE_VERTEX);
+        // self loops are in both lists, they are dropped with the out edges
+        for(auto e : _vert->m_inedgelist)
+          if(e->source() != _vert) {
+            notify_erasing(e);
+            e->source()->m_outedgelist.erase(e);
+            drop_edge(e);
+          }
 
-        for(;out_iter != _vert->out_end(); ++out_iter) {
-          (*out_iter)->target()->remove_edge(*out_iter);
-          m_edge.erase(*out_iter);
+        for(auto e : _vert->m_outedgelist) {
+          notify_erasing(e);
+          if(e->target() != _vert)
+            e->target()->m_inedgelist.erase(e);
+          drop_edge(e);
         }
+        for(auto o : m_observers)
+          o->erasing(_vert);
+        remove_index(_vert);
         m_vertex.erase(_vert);
+        delete _vert;
       }
       
       void erase_edge(edge* _edge) {
+        NOSTD_TIME_OP(ERASE_EDGE);
+        notify_erasing(_edge);
 
         _edge->source()->remove_edge(_edge);
         _edge->target()->remove_edge(_edge);
-        
-        m_edge.erase(_edge);
+
+        drop_edge(_edge);
       }
 #endif     
       /// @}
       /// @name Graph Statistics
       /// @{
 
-      size_t num_vertices() { return m_vertex.size(); }
-      size_t num_edges() { return m_edge.size(); } 
+      size_t num_vertices() const { return m_vertex.size(); }
+      size_t num_edges() const { return m_edge.size(); }
 
       void clear() {
-        for(auto& i : m_edge)
-          delete i;
-        for(auto& i : m_vertex)
-          delete i;
-        
-        m_edge.clear();
-        m_vertex.clear();
+        release();
+        notify_reset();
       }
       
       /// @}
@@ -258,6 +436,101 @@ namespace nostd {
       const_vertex_iterator begin() const { return m_vertex.begin(); }
       const_vertex_iterator end() const { return m_vertex.end(); }
 
+      edge_iterator edge_begin() { return m_edge.begin(); }
+      edge_iterator edge_end() { return m_edge.end(); }
+
+      const_edge_iterator edge_begin() const { return m_edge.begin(); }
+      const_edge_iterator edge_end() const { return m_edge.end(); }
+
+#ifndef DESCRIPTOR_GRAPH
+      /// @}
+      /// @name Adjacency
+      /// @{
+
+      // Algorithms walk the graph through these rather than through the
+      // vertices, so the views in graph_view.h can stand in for a graph.
+
+      adj_iterator out_begin(vertex* _vert) const { return _vert->out_begin(); }
+      adj_iterator out_end(vertex* _vert) const { return _vert->out_end(); }
+
+      adj_iterator in_begin(vertex* _vert) const { return _vert->in_begin(); }
+      adj_iterator in_end(vertex* _vert) const { return _vert->in_end(); }
+
+      size_t out_degree(const vertex* _vert) const { return _vert->out_degree(); }
+      size_t in_degree(const vertex* _vert) const { return _vert->in_degree(); }
+
+      vertex* source(edge* _edge) const { return _edge->source(); }
+      vertex* target(edge* _edge) const { return _edge->target(); }
+
+      bool contains(const vertex*) const { return true; }
+      bool contains(const edge*) const { return true; }
+#endif
+
+      /// @}
+      /// @name Index Access
+      /// @{
+
+      /// @return The vertex with index _index in [0, num_vertices())
+      vertex* vertex_at(size_t _index) const { return m_index[_index]; }
+
+      /// @return The edge with index _index in [0, num_edges())
+      edge* edge_at(size_t _index) const { return m_edge_index[_index]; }
+
+      /// @brief Moves the vertex with index i to index _perm[i]. _perm must
+      ///        be a permutation of [0, num_vertices()).
+      void relabel(const std::vector<size_t>& _perm) {
+        std::vector<vertex*> index(m_index.size());
+        for(size_t i = 0; i < m_index.size(); ++i) {
+          index[_perm[i]] = m_index[i];
+          m_index[i]->m_index = _perm[i];
+        }
+        m_index.swap(index);
+        notify_reset();
+      }
+
+#ifndef DESCRIPTOR_GRAPH
+      /// @}
+      /// @name Observers
+      /// @{
+
+      /////////////////////////////////////////////////////////////////////////
+      /// @brief Told about every change to a graph it is attached to. All
+      ///        events do nothing by default.
+      /////////////////////////////////////////////////////////////////////////
+      class observer {
+        public:
+          virtual ~observer() {}
+
+          /// @brief After a vertex was inserted
+          virtual void inserted(vertex*) {}
+
+          /// @brief After an edge was inserted
+          virtual void inserted(edge*) {}
+
+          /// @brief Before an edge is freed. Its endpoints are still valid
+          ///        but it may already be out of their adjacency lists.
+          virtual void erasing(edge*) {}
+
+          /// @brief Before a vertex is freed, after erasing() of its edges
+          virtual void erasing(vertex*) {}
+
+          /// @brief After a change not reported piece by piece: clear(),
+          ///        relabel(), swap() or assignment
+          virtual void reset() {}
+      };
+
+      /// @brief Calls _observer on every change until it is detached. The
+      ///        graph must outlive its observers.
+      void attach(observer* _observer) { m_observers.push_back(_observer); }
+
+      /// @brief Stops calling _observer; does nothing if it is not attached
+      void detach(observer* _observer) {
+        auto iter = std::find(m_observers.begin(), m_observers.end(), _observer);
+        if(iter != m_observers.end())
+          m_observers.erase(iter);
+      }
+#endif
+
       /// @}
       /// @name Internal Structures
       /// @{
@@ -271,8 +544,17 @@ namespace nostd {
           vertex(const VertProp& _prop = VertProp(), 
                  vertex_descriptor _desc = INVALID_VERTEX):
                  m_property(_prop), m_descriptor(_desc) {}
+
+          template<typename... Args>
+          vertex(std::in_place_t, Args&&... _args):
+                 m_property(std::forward<Args>(_args)...),
+                 m_descriptor(INVALID_VERTEX) {}
 #else
           vertex(const VertProp& _prop = VertProp()): m_property(_prop) {}
+
+          template<typename... Args>
+          vertex(std::in_place_t, Args&&... _args):
+                 m_property(std::forward<Args>(_args)...) {}
 #endif
           /// @}
           /// @name Object Access and Manipulation
@@ -294,31 +576,33 @@ namespace nostd {
 
           edge_descriptor find(vertex_descriptor _vert) { 
             for(auto& i : m_inedgelist) {
-              auto op = get_opposite(i, _vert);
+              auto op = get_opposite(i, m_descriptor);
               if(op == _vert)
                return i;
             }
             for(auto& i : m_outedgelist) {
-              auto op = get_opposite(i, _vert);
+              auto op = get_opposite(i, m_descriptor);
               if(op == _vert)
                return i;
             }
 
-            return INVALID_VERTEX; 
+            return std::make_pair(INVALID_VERTEX, INVALID_VERTEX); 
           }
 
-          size_t degree() { return m_inedgelist.size() + m_outedgelist.size(); }
+          size_t degree() const { return m_inedgelist.size() + m_outedgelist.size(); }
+          size_t in_degree() const { return m_inedgelist.size(); }
+          size_t out_degree() const { return m_outedgelist.size(); }
 
           void remove_edge(edge_descriptor _edge) {
+            if(m_descriptor != _edge.first && m_descriptor != _edge.second)
+              printf("Error Edge not on vertex\n");
             if(m_descriptor == _edge.first)
-              m_inedgelist.erase(_edge);
-            else if(m_descriptor == _edge.second)
               m_outedgelist.erase(_edge);
-            else
-              printf("Error Edge not on vertex\n");              
+            if(m_descriptor == _edge.second)
+              m_inedgelist.erase(_edge);
           }
 
-          vertex_descriptor descriptor() {
+          vertex_descriptor descriptor() const {
             return m_descriptor;
           }
 
@@ -348,18 +632,23 @@ namespace nostd {
             return nullptr; 
           }
 
-          size_t degree() { return m_inedgelist.size() + m_outedgelist.size(); }
+          size_t degree() const { return m_inedgelist.size() + m_outedgelist.size(); }
+          size_t in_degree() const { return m_inedgelist.size(); }
+          size_t out_degree() const { return m_outedgelist.size(); }
 
           void remove_edge(edge* _edge) {
+            if(this != _edge->source() && this != _edge->target())
+              printf("Error Edge not on vertex\n");
             if(this == _edge->source())
-              m_inedgelist.erase(_edge);
-            else if(this == _edge->target())
               m_outedgelist.erase(_edge);
-            else
-              printf("Error Edge not on vertex\n");              
+            if(this == _edge->target())
+              m_inedgelist.erase(_edge);
           }
 #endif
 
+          /// @return Dense index of the vertex in [0, num_vertices())
+          size_t index() const { return m_index; }
+
           /// @}
           /// @name Iterators
           /// @{
@@ -380,6 +669,7 @@ namespace nostd {
            
         protected:
           VertProp m_property;                        // property of the vertex
+          size_t m_index;                             // dense index in the graph
 #ifdef DESCRIPTOR_GRAPH
           vertex_descriptor m_descriptor; 
           std::set<edge_descriptor> m_inedgelist;
@@ -392,6 +682,8 @@ namespace nostd {
           // maybe expand the class to allow for the
           // containers to be either vectors, sets, or unordered_sets
           // for now it will remain a set.
+
+          friend class graph;
       };
 
 
@@ -403,10 +695,22 @@ namespace nostd {
           edge(vertex_descriptor _source, vertex_descriptor _target,
               const EdgeProp& _prop = EdgeProp()) :
               m_property(_prop), m_descriptor(std::make_pair(_source, _target)) {}
+
+          template<typename... Args>
+          edge(vertex_descriptor _source, vertex_descriptor _target,
+              std::in_place_t, Args&&... _args) :
+              m_property(std::forward<Args>(_args)...),
+              m_descriptor(std::make_pair(_source, _target)) {}
 #else     
           edge(vertex* _source, vertex* _target, 
               const EdgeProp& _prop = EdgeProp()):
               m_property(_prop), m_source(_source), m_target(_target) {}
+
+          template<typename... Args>
+          edge(vertex* _source, vertex* _target, std::in_place_t,
+              Args&&... _args):
+              m_property(std::forward<Args>(_args)...),
+              m_source(_source), m_target(_target) {}
 #endif      
           /// @}
           /// @name Object Access and Manipulation
@@ -415,11 +719,14 @@ namespace nostd {
           EdgeProp& property() { return m_property; }
           const EdgeProp& property() const { return m_property; }
 
+          /// @return Dense index of the edge in [0, num_edges())
+          size_t index() const { return m_index; }
+
 #ifdef DESCRIPTOR_GRAPH
           vertex_descriptor source() { return m_descriptor.first; }
           vertex_descriptor target() { return m_descriptor.second; }
 
-          edge_descriptor descriptor() {
+          edge_descriptor descriptor() const {
             return m_descriptor;
           }
 
@@ -448,20 +755,139 @@ namespace nostd {
           
         protected:
           EdgeProp m_property;                      // property of the edge
+          size_t m_index;                           // dense index in the graph
 #ifdef DESCRIPTOR_GRAPH
           edge_descriptor m_descriptor;
 #else
           vertex* m_source;                 // source vertex of the edge
           vertex* m_target;                 // target vertex of the edge
 #endif
+
+          friend class graph;
       };
 
     protected:
+      // frees every vertex and edge without telling the observers
+      void release() {
+        for(auto& i : m_edge)
+          delete i;
+        for(auto& i : m_vertex)
+          delete i;
+
+        m_edge.clear();
+        m_vertex.clear();
+        m_index.clear();
+        m_edge_index.clear();
+      }
+
+#ifdef DESCRIPTOR_GRAPH
+      void notify_reset() {}
+#else
+      void notify_reset() {
+        for(auto o : m_observers)
+          o->reset();
+      }
+
+      void notify_erasing(edge* _edge) {
+        for(auto o : m_observers)
+          o->erasing(_edge);
+      }
+#endif
+
+      void add_index(vertex* _vert) {
+        _vert->m_index = m_index.size();
+        m_index.push_back(_vert);
+      }
+
+      // moves the last vertex into the hole left by _vert
+      void remove_index(vertex* _vert) {
+        vertex* last = m_index.back();
+        last->m_index = _vert->m_index;
+        m_index[last->m_index] = last;
+        m_index.pop_back();
+      }
+
+      void add_edge_index(edge* _edge) {
+        _edge->m_index = m_edge_index.size();
+        m_edge_index.push_back(_edge);
+      }
+
+      void remove_edge_index(edge* _edge) {
+        edge* last = m_edge_index.back();
+        last->m_index = _edge->m_index;
+        m_edge_index[last->m_index] = last;
+        m_edge_index.pop_back();
+      }
+
+      // unlinks _edge from the graph's containers and frees it; the
+      // caller has already taken it out of the adjacency lists
+      void drop_edge(edge* _edge) {
+        remove_edge_index(_edge);
+        m_edge.erase(_edge);
+        delete _edge;
+      }
+
+#ifndef DESCRIPTOR_GRAPH
+      // scans the shorter of the two adjacency lists
+      static edge* connecting(vertex* _source, vertex* _target) {
+        if(_source->out_degree() <= _target->in_degree()) {
+          for(auto e : _source->m_outedgelist)
+            if(e->target() == _target)
+              return e;
+        }
+        else {
+          for(auto e : _target->m_inedgelist)
+            if(e->source() == _source)
+              return e;
+        }
+        return nullptr;
+      }
+#endif
+
+      // rebuilds the vertices and edges of _other in index order, so the
+      // copy has the same indices (and descriptors)
+      void copy(const graph& _other) {
+        m_index.reserve(_other.m_index.size());
+        m_edge_index.reserve(_other.m_edge_index.size());
+        for(auto v : _other.m_index) {
+          vertex* temp = new vertex(std::in_place, v->m_property);
+#ifdef DESCRIPTOR_GRAPH
+          temp->m_descriptor = v->m_descriptor;
+#endif
+          m_vertex.insert(temp);
+          add_index(temp);
+        }
+        for(auto e : _other.m_edge_index) {
+#ifdef DESCRIPTOR_GRAPH
+          edge* temp = new edge(e->m_descriptor.first, e->m_descriptor.second,
+                                std::in_place, e->m_property);
+          (*find_vertex(temp->m_descriptor.first))->add_outedge(temp->m_descriptor);
+          (*find_vertex(temp->m_descriptor.second))->add_inedge(temp->m_descriptor);
+#else
+          edge* temp = new edge(m_index[e->m_source->m_index],
+                                m_index[e->m_target->m_index],
+                                std::in_place, e->m_property);
+          temp->m_source->add_outedge(temp);
+          temp->m_target->add_inedge(temp);
+#endif
+          m_edge.insert(temp);
+          add_edge_index(temp);
+        }
+#ifdef DESCRIPTOR_GRAPH
+        m_count = _other.m_count;
+#endif
+      }
+
 #ifdef DESCRIPTOR_GRAPH
       vertex_descriptor m_count;
 #endif
-      std::set<vertex*> m_vertex;
-      std::set<edge*> m_edge;
+      std::set<vertex*, vertex_less> m_vertex;
+      std::set<edge*, edge_less> m_edge;
+      std::vector<vertex*> m_index;         // vertices ordered by index
+      std::vector<edge*> m_edge_index;      // edges ordered by index
+#ifndef DESCRIPTOR_GRAPH
+      std::vector<observer*> m_observers;
+#endif
   };
 }
 
@@ -8,118 +8,239 @@
 ///       concept. This will be used by all graph algorithms for returning
 ///       the results of the algorthim back to the user.
 ///
+///       Every algorithm takes an optional executor. Without one the
+///       algorithm runs serially on the calling thread; with one the
+///       visitor actions may be called concurrently.
+///
+///       Per vertex state is kept in dense property maps inside a
+///       workspace. Pass the same workspace to repeated runs to reuse its
+///       buffers.
+///
+///       The graph is only walked through its adjacency interface
+///       (out_begin, target, ...), so the views in graph_view.h work in
+///       place of a graph.
+///
 ///////////////////////////////////////////////////////////////////////////////
 #ifndef GRAPH_ALGORITHM_H
 #define GRAPH_ALGORITHM_H
 
-#include <queue>
-#include <stack>
+#include <vector>
 
 #include <utility>
-#include <map>
 #include <limits>
 #include <cmath>
 
+#include "../Parallel/executor.h"
+#include "instrument.h"
+#include "property_map.h"
+
 namespace nostd {
-  
-  template<typename Map>
-  static void change_value(Map& _map, Map::key_type _key, Map::mapped_type _value) {
-    _map[_key] = _value;
-  }
-  
-  enum Label { WHITE, GREY, BLACK }; 
 
-  // I still need to implement a method of getting the data out of the algorithm
-  // for now the algorithm is just running and not returning anything
-  // useful 
-  template<typename GraphType, typename VistorType>
+  enum Label { WHITE, GREY, BLACK };
+
+  /// @brief Reusable buffers of breath_first_search. After a run labels
+  ///        holds the color of every vertex. Once the buffers have grown to
+  ///        the graph a serial run does no heap allocation.
+  template<typename GraphType>
+  struct bfs_workspace {
+    typedef typename GraphType::vertex vertex;
+
+    vertex_property_map<atomic_cell<Label>> labels;
+    std::vector<vertex*> frontier;
+    std::vector<std::vector<vertex*>> next;     // one per worker
+  };
+
+  /// @brief Level synchronous breadth first search from _root. Each level
+  ///        of the search is expanded with a parallel loop over the
+  ///        frontier when an executor is given; serially the vertices are
+  ///        visited in the same order as a queue based search.
+  template<typename GraphType, typename VisitorType>
   void breath_first_search(const GraphType& _graph,
-                            VistoryType& _vistor) {
-    const double infi = std::numeric_limits<double>::infinity();
-    std::map<GraphType::vertex*, 
-             std::pair<double, GraphType::vertex*>> 
-             algo_values;
-    std::map<GraphType::vertex*, Label> vertex_label;
-    std::queue<GraphType::vertex*> algo_queue;
-
-    for(auto& v_iter : _graph) {
-//      algo_values.emplace(
-//            v_iter,
-//            std::make_pair(
-//              infi,   // distance
-//              nullptr // parent
-//            )
-//          );
-
-      vertex_label.emplate(v_iter, WHITE);
-    }
-
-    vertex* root = *_graph.begin();
-    _vistor.discover_vertex(root, _graph);
-//    auto& d = algo_values[root];
-//    d.first = 0;
-    change_value(vertex_label, root, GREY);
-    algo_queue.push(root); 
-
-    while(!algo_queue.empty()) {
-      auto current = algo_queue.front(); algo_queue.pop();
-      _vistor.examine_vertex(currnet, _graph);
-      for(auto iter = current->out_begin();
-          _vistor.examine_edge(*iter, _graph);
-          iter != current->out_end(); 
-          ++iter) {
-        // The algorithm might not need the second expression
-        if(vertex_label[*iter] == WHITE) {
-
-          change_value(vertex_label, (*iter)->target(), GREY);
-
-          _vistor.tree_edge(*iter, _graph);
-          _vistor.discover_vertex((*iter)->target(), _graph);
-
-         // algo_values[*iter].first = algo_values[current].first + 1;
-         // algo_values[*iter].second = *iter;
-          algo_queue.push(*iter);
-
-        }
-        else {
-          _visitor.non_tree_edge(*iter, _graph);
-          if(vertex_label[*iter] == GREY)
-            _visitor.grey_target(*iter, _graph);
-          else
-            _visitor.black_target(*iter, _graph);
+                           typename GraphType::vertex* _root,
+                           VisitorType& _visitor,
+                           bfs_workspace<GraphType>& _work,
+                           executor* _exec = nullptr) {
+    NOSTD_ALGO_RUN(BFS);
+
+    auto& labels = _work.labels;
+    auto& frontier = _work.frontier;
+    auto& next = _work.next;
+
+    labels.reset(_graph, atomic_cell<Label>(WHITE));
+    parallel_for(_exec, 0, _graph.num_vertices(), [&](size_t i) {
+      auto vert = _graph.vertex_at(i);
+      if(_graph.contains(vert))
+        _visitor.initialize_vertex(vert, _graph);
+    });
+
+    if(_root == nullptr)
+      return;
+
+    size_t slots = (_exec == nullptr) ? 1 : _exec->num_threads() + 1;
+    if(next.size() < slots)
+      next.resize(slots);
+    frontier.clear();
+    frontier.push_back(_root);
+
+    labels[_root].store(GREY);
+    _visitor.discover_vertex(_root, _graph);
+
+    while(!frontier.empty()) {
+      NOSTD_ALGO_FRONTIER(frontier.size());
+      NOSTD_ALGO_VERTICES(frontier.size());
+      parallel_for(_exec, 0, frontier.size(), [&](size_t i) {
+        auto current = frontier[i];
+        auto& local = next[(_exec == nullptr) ? 0 : _exec->worker_id()];
+        _visitor.examine_vertex(current, _graph);
+        NOSTD_ALGO_LOCAL_EDGES();
+        for(auto iter = _graph.out_begin(current);
+            iter != _graph.out_end(current);
+            ++iter) {
+          _visitor.examine_edge(*iter, _graph);
+          NOSTD_ALGO_ADD_EDGES(1);
+
+          auto target = _graph.target(*iter);
+          Label label = WHITE;
+          if(labels[target].compare_exchange(label, GREY)) {
+            _visitor.tree_edge(*iter, _graph);
+            _visitor.discover_vertex(target, _graph);
+            local.push_back(target);
+          }
+          else {
+            _visitor.non_tree_edge(*iter, _graph);
+            if(label == GREY)
+              _visitor.grey_target(*iter, _graph);
+            else
+              _visitor.black_target(*iter, _graph);
+          }
         }
+        labels[current].store(BLACK);
+        _visitor.finish_vertex(current, _graph);
+      }, 0, DYNAMIC);
+
+      frontier.clear();
+      for(auto& n : next) {
+        frontier.insert(frontier.end(), n.begin(), n.end());
+        n.clear();
       }
-      _visitor.finish_vertex(current, _graph);
     }
+  }
 
+  /// @brief Breadth first search from _root with its own buffers.
+  template<typename GraphType, typename VisitorType>
+  void breath_first_search(const GraphType& _graph,
+                           typename GraphType::vertex* _root,
+                           VisitorType& _visitor,
+                           executor* _exec = nullptr) {
+    bfs_workspace<GraphType> work;
+    breath_first_search(_graph, _root, _visitor, work, _exec);
+  }
+
+  /// @brief Breadth first search from the first vertex of the graph.
+  template<typename GraphType, typename VisitorType>
+  void breath_first_search(const GraphType& _graph,
+                           VisitorType& _visitor,
+                           executor* _exec = nullptr) {
+    typename GraphType::vertex* root = nullptr;
+    if(_graph.begin() != _graph.end())
+      root = *_graph.begin();
+    breath_first_search(_graph, root, _visitor, _exec);
   }
 
-  template<typename GraphType, typename VistorType>
+  /// @brief Reusable buffers of depth_first_search. After a run labels
+  ///        holds the color of every vertex.
+  template<typename GraphType>
+  struct dfs_workspace {
+    typedef typename GraphType::vertex vertex;
+    typedef typename GraphType::adj_iterator adj_iterator;
+
+    vertex_property_map<Label> labels;
+    std::vector<std::pair<vertex*, adj_iterator>> stack;
+  };
+
+  /// @brief Depth first search from _root. The search itself is inherently
+  ///        sequential, the executor is only used to initialize the
+  ///        vertices.
+  template<typename GraphType, typename VisitorType>
   void depth_first_search(const GraphType& _graph,
-                            VistorType& _vistor) {
-    std::map<GraphType::vertex*, Label> graph_labels;
-    for(auto& v : _graph) {
-      _vistor.initialize_vertex(v, _graph);
-      graph_labels.emplate(WHITE);
-    }
+                          typename GraphType::vertex* _root,
+                          VisitorType& _visitor,
+                          dfs_workspace<GraphType>& _work,
+                          executor* _exec = nullptr) {
+    NOSTD_ALGO_RUN(DFS);
+
+    auto& labels = _work.labels;
+    auto& algo_stack = _work.stack;
+
+    labels.reset(_graph, WHITE);
+    parallel_for(_exec, 0, _graph.num_vertices(), [&](size_t i) {
+      auto vert = _graph.vertex_at(i);
+      if(_graph.contains(vert))
+        _visitor.initialize_vertex(vert, _graph);
+    });
+
+    if(_root == nullptr)
+      return;
+
+    algo_stack.clear();
+    labels[_root] = GREY;
+    _visitor.discover_vertex(_root, _graph);
+    algo_stack.push_back(std::make_pair(_root, _graph.out_begin(_root)));
+    NOSTD_ALGO_VERTICES(1);
 
-    std::stack<GraphType::vertex*> algo_stack;
-    algo_stack.push(*_graph.begin());
     while(!algo_stack.empty()) {
-      auto current = algo_stack.top(); algo_stack.pop();
-      if(graph_labels[current] == WHITE) {
-        graph_labels[current] = BLACK;
-        for(auto iter = current->out_begin();
-            iter != current->out_end(); 
-            ++iter)
-          algo_stack.push(*iter);
+      auto& current = algo_stack.back();
+      if(current.second == _graph.out_end(current.first)) {
+        labels[current.first] = BLACK;
+        _visitor.finish_vertex(current.first, _graph);
+        algo_stack.pop_back();
+        continue;
       }
-      else {
 
+      auto edge = *current.second++;
+      auto target = _graph.target(edge);
+      _visitor.examine_edge(edge, _graph);
+      NOSTD_ALGO_EDGES(1);
+
+      Label label = labels[target];
+      if(label == WHITE) {
+        labels[target] = GREY;
+        _visitor.tree_edge(edge, _graph);
+        _visitor.discover_vertex(target, _graph);
+        algo_stack.push_back(std::make_pair(target, _graph.out_begin(target)));
+        NOSTD_ALGO_VERTICES(1);
+      }
+      else {
+        _visitor.non_tree_edge(edge, _graph);
+        if(label == GREY)
+          _visitor.grey_target(edge, _graph);
+        else
+          _visitor.black_target(edge, _graph);
       }
     }
   }
 
+  /// @brief Depth first search from _root with its own buffers.
+  template<typename GraphType, typename VisitorType>
+  void depth_first_search(const GraphType& _graph,
+                          typename GraphType::vertex* _root,
+                          VisitorType& _visitor,
+                          executor* _exec = nullptr) {
+    dfs_workspace<GraphType> work;
+    depth_first_search(_graph, _root, _visitor, work, _exec);
+  }
+
+  /// @brief Depth first search from the first vertex of the graph.
+  template<typename GraphType, typename VisitorType>
+  void depth_first_search(const GraphType& _graph,
+                          VisitorType& _visitor,
+                          executor* _exec = nullptr) {
+    typename GraphType::vertex* root = nullptr;
+    if(_graph.begin() != _graph.end())
+      root = *_graph.begin();
+    depth_first_search(_graph, root, _visitor, _exec);
+  }
+
 }
 
 #endif
@@ -1,21 +1,311 @@
 #include "graph.h"
-#include "unit_test.h"
+#include "graph_algorithm.h"
+#include "csr_graph.h"
+#include "reorder.h"
+#include "compressed_graph.h"
+#include "multi_source_bfs.h"
+#include "shortest_path.h"
+#include "traversal_range.h"
+#include "graph_view.h"
+#include "spanning_tree.h"
+#include "dynamic_algorithm.h"
+#include "core_decomposition.h"
+#include "visitor.h"
+#include "../Test/unit_test.h"
+#include <algorithm>
 #include <set>
+#include <vector>
+#include <atomic>
 #include <cassert>
+#include <cstdlib>
 
 using nostd::graph;
 
+// records the order vertices are discovered and counts tree edges
+class order_visitor : public nostd::base_visitor<std::vector<int>> {
+  public:
+    template<typename V, typename Graph>
+    void discover_vertex(V _vert, const Graph&) {
+      m_vis.push_back(_vert->property());
+    }
+
+    template<typename E, typename Graph>
+    void tree_edge(E, const Graph&) { ++tree_edges; }
+
+    int tree_edges = 0;
+};
+
+// safe to use with an executor
+class count_visitor : public nostd::base_visitor<int> {
+  public:
+    template<typename V, typename Graph>
+    void discover_vertex(V, const Graph&) { ++discovered; }
+
+    template<typename E, typename Graph>
+    void tree_edge(E, const Graph&) { ++tree_edges; }
+
+    std::atomic<int> discovered{0};
+    std::atomic<int> tree_edges{0};
+};
+
+// counts how often properties are copied
+struct counted {
+  static int copies;
+
+  counted(int _value = 0): value(_value) {}
+  counted(const counted& _other): value(_other.value) { ++copies; }
+  counted(counted&& _other) noexcept: value(_other.value) {}
+  counted& operator=(const counted& _other) {
+    value = _other.value;
+    ++copies;
+    return *this;
+  }
+  counted& operator=(counted&&) noexcept = default;
+
+  int value;
+};
+
+int counted::copies = 0;
+
+// has no default constructor, so a graph lookup can not build one
+struct labeled {
+  explicit labeled(int _value): value(_value) {}
+  int value;
+};
+
 class graph_test : public test_class {
 
+#ifdef DESCRIPTOR_GRAPH
+  // the algorithms take vertex and edge pointers, so only the graph itself
+  // is tested through descriptors
+  void test() {
+    descriptor_insert();
+    descriptor_find();
+    descriptor_erase();
+    descriptor_ownership();
+    descriptor_parallel_edge();
+  }
+
+  void descriptor_insert() {
+    graph<int, int> g;
+    auto v0 = g.insert_vertex(1);
+    auto v1 = g.insert_vertex(2);
+    auto e = g.insert_edge(v0, v1, 10);
+
+    assert(v0 == 0 && v1 == 1 && e == std::make_pair(v0, v1));
+    assert(g.num_vertices() == 2 && g.num_edges() == 1);
+    assert((*g.find_vertex(v0))->out_degree() == 1 &&
+           (*g.find_vertex(v1))->in_degree() == 1);
+    assert((*g.find_vertex(v0))->find(v1) == e);
+  }
+
+  void descriptor_find() {
+    typedef graph<labeled, labeled> labeled_graph;
+    labeled_graph g;
+    auto v0 = g.emplace_vertex(1);
+    auto v1 = g.emplace_vertex(2);
+    auto v2 = g.emplace_vertex(3);
+    auto e = g.emplace_edge(v0, v1, 10);
+    g.emplace_edge(v1, v2, 20);
+
+    // lookups take a plain descriptor
+    assert((*g.find_vertex(v2))->property().value == 3);
+    assert(g.find_vertex(v2 + 1) == g.end());
+    assert((*g.find_edge(v0, v1))->property().value == 10);
+    assert((*g.find_edge(e))->descriptor() == e);
+    assert(g.find_edge(v1, v0) == g.edge_end());
+
+    const labeled_graph& cg = g;
+    assert((*cg.find_vertex(v1))->property().value == 2);
+    assert((*cg.find_edge(v1, v2))->property().value == 20);
+    assert(cg.find_edge(v2, v0) == cg.edge_end());
+  }
+
+  void descriptor_erase() {
+    graph<int, int> g;
+    auto v0 = g.insert_vertex(0);
+    auto v1 = g.insert_vertex(1);
+    auto v2 = g.insert_vertex(2);
+    auto v3 = g.insert_vertex(3);
+    g.insert_edge(v0, v1, 1);
+    g.insert_edge(v1, v2, 2);
+    g.insert_edge(v2, v1, 3);
+    g.insert_edge(v1, v1, 4);
+    g.insert_edge(v2, v3, 5);
+
+    // the self loop and both directions go with the vertex
+    g.erase_vertex(v1);
+    assert(g.num_vertices() == 3 && g.num_edges() == 1);
+    assert(g.find_vertex(v1) == g.end() && g.find_edge(v0, v1) == g.edge_end());
+    assert((*g.find_vertex(v0))->out_degree() == 0 &&
+           (*g.find_vertex(v2))->degree() == 1);
+
+    // descriptors are kept, indices stay dense
+    for(size_t i = 0; i < g.num_vertices(); ++i)
+      assert(g.vertex_at(i)->index() == i);
+    assert(g.edge_at(0)->descriptor() == std::make_pair(v2, v3));
+    assert(g.insert_vertex(4) == v3 + 1);
+
+    g.erase_edge(std::make_pair(v2, v3));
+    assert(g.num_edges() == 0 && (*g.find_vertex(v3))->in_degree() == 0);
+  }
+
+  void descriptor_ownership() {
+    typedef graph<counted, counted> counted_graph;
+    counted::copies = 0;
+
+    counted_graph g;
+    auto v0 = g.emplace_vertex(1);
+    auto v1 = g.insert_vertex(counted(2));
+    auto v2 = g.emplace_vertex(3);
+    g.emplace_edge(v0, v1, 10);
+    g.insert_edge(v1, v2, counted(20));
+    g.erase_vertex(v1);
+    g.emplace_edge(v2, v0, 30);
+    assert(counted::copies == 0);
+
+    // deep copy, same descriptors and indices, separate objects
+    counted_graph copy(g);
+    assert(counted::copies == 3 && copy.num_edges() == 1);
+    assert(copy.vertex_at(0) != g.vertex_at(0));
+    for(size_t i = 0; i < g.num_vertices(); ++i)
+      assert(copy.vertex_at(i)->descriptor() == g.vertex_at(i)->descriptor());
+    assert((*copy.find_edge(v2, v0))->property().value == 30);
+    assert((*copy.find_vertex(v0))->in_degree() == 1);
+    assert(copy.insert_vertex(counted(4)) == g.insert_vertex(counted(4)));
+
+    copy.erase_vertex(v0);
+    assert(copy.num_edges() == 0 && g.num_edges() == 1);
+
+    // moves only swap containers
+    counted::copies = 0;
+    auto front = g.vertex_at(0);
+    counted_graph moved(std::move(g));
+    assert(g.num_vertices() == 0 && moved.vertex_at(0) == front);
+    g = std::move(moved);
+    assert(counted::copies == 0 && g.num_edges() == 1 && moved.num_edges() == 0);
+  }
+
+  // edges are keyed by their endpoints, so a second edge between the same
+  // vertices is not inserted and leaves nothing behind in the index
+  void descriptor_parallel_edge() {
+    graph<int, int> g;
+    auto v0 = g.insert_vertex(0);
+    auto v1 = g.insert_vertex(1);
+    auto v2 = g.insert_vertex(2);
+    auto e = g.insert_edge(v0, v1, 10);
+    g.insert_edge(v1, v2, 20);
+
+    assert(g.insert_edge(v0, v1, 30) == e);
+    assert(g.num_edges() == 2 && (*g.find_edge(e))->property() == 10);
+    assert((*g.find_vertex(v0))->out_degree() == 1 &&
+           (*g.find_vertex(v1))->in_degree() == 1);
+
+    // a later edge still gets the next index, so a map sized by the graph
+    // covers every edge
+    auto e2 = g.insert_edge(v2, v0, 40);
+    assert(g.num_edges() == 3 && (*g.find_edge(e2))->index() == 2);
+    nostd::edge_property_map<int> weight(g);
+    for(auto i = g.edge_begin(); i != g.edge_end(); ++i) {
+      assert((*i)->index() < weight.size() && g.edge_at((*i)->index()) == *i);
+      weight[*i] = (*i)->property();
+    }
+    assert(weight[size_t(0)] + weight[size_t(1)] + weight[size_t(2)] == 70);
+
+    // the last index moves into the hole; it must be a real edge
+    g.erase_edge(std::make_pair(v1, v2));
+    assert(g.num_edges() == 2 && g.edge_at(1) == *g.find_edge(e2) &&
+           g.edge_at(1)->index() == 1);
+  }
+#else
   void test() {
     vertex_insert();
     edge_insert();
     vertex_remove();
     edge_remove();
     edge_opposite();
+    find_edge();
     find_adj_edge();
+    bfs();
+    dfs();
+    vertex_index();
+    csr();
+    reorder();
+    compressed();
+    property_maps();
+    ownership();
+    multi_source();
+    shortest_paths();
+    traversal_ranges();
+    views();
+    spanning_forest();
+    dynamic();
+    cores();
+#ifdef NOSTD_INSTRUMENT
+    instrumentation();
+#endif
+  }
+
+  // a grid with random weights; the searches reuse their workspaces, so
+  // the benchmarks also check that they stop allocating
+  void benchmarks() {
+    typedef graph<int, unsigned> weighted;
+    const size_t side = 100;
+    weighted g;
+    std::vector<weighted::vertex*> verts;
+    for(size_t i = 0; i < side * side; ++i)
+      verts.push_back(g.insert_vertex(int(i)));
+    srand(3);
+    for(size_t y = 0; y < side; ++y)
+      for(size_t x = 0; x < side; ++x) {
+        size_t c = y * side + x;
+        if(x + 1 < side)
+          g.insert_undirected(verts[c], verts[c + 1], 1 + rand() % 100);
+        if(y + 1 < side)
+          g.insert_undirected(verts[c], verts[c + side], 1 + rand() % 100);
+      }
+
+    count_visitor counter;
+    nostd::bfs_workspace<weighted> bfs_work;
+    auto& bfs = benchmark("breath_first_search", [&] {
+      nostd::breath_first_search(g, verts[0], counter, bfs_work);
+    });
+    assert_msg(bfs.allocations == 0, "breath_first_search allocates");
+
+    nostd::traversal_workspace<weighted> range_work;
+    auto& range = benchmark("bfs_range", [&] {
+      size_t reached = 0;
+      for(auto v : nostd::bfs_range<weighted>(g, verts[0], range_work))
+        reached += (v != nullptr);
+      do_not_optimize(reached);
+    });
+    assert_msg(range.allocations == 0, "bfs_range allocates");
+
+    nostd::csr_graph<weighted> csr(g);
+    std::vector<uint32_t> dist;
+    benchmark("csr breath_first_search", [&] {
+      nostd::breath_first_search(csr, 0, dist);
+      do_not_optimize(dist.data());
+    });
+
+    nostd::path_workspace<weighted> path_work;
+    auto& dijkstra = benchmark("bidirectional_dijkstra_search", [&] {
+      do_not_optimize(nostd::bidirectional_dijkstra_search(g, verts[0], verts.back(),
+                                                           path_work));
+    });
+    assert_msg(dijkstra.allocations == 0, "bidirectional_dijkstra_search allocates");
+
+    nostd::vertex_property_map<uint32_t> core;
+    benchmark("core_numbers", [&] {
+      do_not_optimize(nostd::core_numbers(g, core, nostd::OUT_DEGREE));
+    });
+
+    benchmark("insert and erase edge", [&] {
+      g.erase_edge(g.insert_edge(verts[0], verts[side + 1], 1));
+    });
   }
 
+
   void build_graph(graph<int, int>& _g) {
     auto v1 = _g.insert_vertex(1);
     auto v2 = _g.insert_vertex(2);
@@ -87,7 +377,7 @@ class graph_test : public test_class {
     g.insert_edge(v3, v4, 3);
     
     auto e1 = g.find_edge(v1, v2);
-    assert(*e1 == e);
+    assert(*e1 == e && g.find_edge(v2, v1) == g.edge_end());
   }
 
   void edge_opposite() {
@@ -126,19 +416,822 @@ class graph_test : public test_class {
     assert(e1 == e);
   }
 
+  void vertex_index() {
+    graph<int, int> g;
+
+    auto v1 = g.insert_vertex(1);
+    auto v2 = g.insert_vertex(2);
+    auto v3 = g.insert_vertex(3);
+    g.insert_edge(v1, v2, 1);
+    g.insert_edge(v2, v3, 1);
+
+    assert(v1->index() == 0 && v3->index() == 2 && g.vertex_at(1) == v2);
+
+    g.erase_vertex(v1);
+    assert(v3->index() == 0 && g.vertex_at(0) == v3 && v2->in_degree() == 0);
+  }
+
+  void property_maps() {
+    graph<int, int> g;
+    build_graph(g);
+    auto e = *g.vertex_at(0)->out_begin();
+    assert(g.num_edges() == 3 && g.edge_at(e->index()) == e);
+
+    nostd::vertex_property_map<int> weight(g, 7);
+    nostd::edge_property_map<int> flow(g);
+    weight[g.vertex_at(2)] = 3;
+    flow[e] = 5;
+    assert(weight[size_t(2)] == 3 && weight[g.vertex_at(0)] == 7 && flow[e] == 5);
+
+    nostd::property_arrays<int, double> fields;
+    fields.reset(g);
+    fields.get<1>()[g.vertex_at(3)] = 0.5;
+    assert(fields.get<0>().size() == 4 && fields.get<1>()[size_t(3)] == 0.5);
+
+    // edge indices stay dense as edges and vertices go away
+    g.erase_edge(e);
+    g.erase_vertex(g.vertex_at(0));
+    assert(g.num_edges() == 2);
+    for(size_t i = 0; i < g.num_edges(); ++i)
+      assert(g.edge_at(i)->index() == i);
+
+    // a reused workspace makes serial searches allocation free
+    order_visitor vis;
+    nostd::bfs_workspace<graph<int, int>> bfs_work;
+    nostd::dfs_workspace<graph<int, int>> dfs_work;
+    nostd::breath_first_search(g, g.vertex_at(0), vis, bfs_work);
+    nostd::depth_first_search(g, g.vertex_at(0), vis, dfs_work);
+    vis.data().reserve(64);
+
+    size_t before = allocation_count();
+    nostd::breath_first_search(g, g.vertex_at(0), vis, bfs_work);
+    nostd::depth_first_search(g, g.vertex_at(0), vis, dfs_work);
+    assert(allocation_count() == before);
+    assert(bfs_work.labels[g.vertex_at(0)].load() == nostd::BLACK);
+  }
+
+  void ownership() {
+    typedef graph<counted, counted> counted_graph;
+    counted::copies = 0;
+
+    counted_graph g;
+    auto v1 = g.emplace_vertex(1);
+    auto v2 = g.insert_vertex(counted(2));
+    auto v3 = g.emplace_vertex(3);
+    g.emplace_edge(v1, v2, 10);
+    g.insert_edge(v2, v3, counted(20));
+    g.insert_undirected(v3, v1, counted(30));
+    assert(counted::copies == 1);              // one side of the undirected pair
+
+    counted::copies = 0;
+    assert(g.find_edge(v3, v1) != g.edge_end() && g.find_edge(v3, v2) == g.edge_end());
+    assert(counted::copies == 0);
+
+    // deep copy, same indices, separate objects
+    counted_graph copy(g);
+    assert(counted::copies == 7 && copy.num_edges() == 4);
+    auto c1 = copy.vertex_at(v1->index());
+    assert(c1 != v1 && c1->property().value == 1 && c1->out_degree() == 2);
+    assert((*c1->in_begin())->source()->property().value == 3);
+    copy.erase_vertex(c1);
+    assert(g.num_edges() == 4 && v1->out_degree() == 2 && copy.num_edges() == 1);
+
+    // moves only swap containers
+    counted::copies = 0;
+    counted_graph moved(std::move(g));
+    assert(g.num_vertices() == 0 && moved.vertex_at(v1->index()) == v1);
+    g = std::move(moved);
+    assert(counted::copies == 0 && g.num_edges() == 4 && moved.num_edges() == 0);
+
+    copy = g;
+    assert(copy.num_vertices() == 3 && copy.vertex_at(0) != g.vertex_at(0));
+  }
+
+  void multi_source() {
+    graph<int, int> g;
+    std::vector<graph<int, int>::vertex*> verts;
+    for(int i = 0; i < 500; ++i)
+      verts.push_back(g.insert_vertex(i));
+    for(int i = 0; i < 500; ++i) {
+      g.insert_edge(verts[i], verts[(i * 13 + 5) % 500], 1);
+      if(i % 3 != 0)
+        g.insert_edge(verts[i], verts[(i + 1) % 500], 1);
+    }
+    nostd::csr_graph<graph<int, int>> c(g);
+
+    // more sources than one tile, with a repeat
+    std::vector<uint32_t> sources;
+    for(uint32_t s = 0; s < 300; ++s)
+      sources.push_back((s * 7) % 500);
+    sources.push_back(0);
+
+    std::vector<uint32_t> expected;
+    for(auto s : sources) {
+      std::vector<uint32_t> dist;
+      nostd::breath_first_search(c, s, dist);
+      expected.insert(expected.end(), dist.begin(), dist.end());
+    }
+
+    nostd::executor exec(2);
+    std::vector<uint32_t> narrow, wide, parallel;
+    nostd::multi_source_bfs(c, sources, narrow);
+    nostd::multi_source_bfs<256>(c, sources, wide);
+    nostd::multi_source_bfs<128>(c, sources, parallel, &exec);
+    assert(narrow == expected && wide == expected && parallel == expected);
+
+    std::atomic<size_t> reached{0};
+    nostd::multi_source_bfs(c, sources, [&](size_t, uint32_t, uint32_t) {
+      ++reached;
+    }, &exec);
+    size_t finite = 0;
+    for(auto d : expected)
+      if(d != c.INVALID_ID)
+        ++finite;
+    assert(reached == finite);
+  }
+
+  void shortest_paths() {
+    typedef graph<int, unsigned> weighted;
+    weighted g;
+    std::vector<weighted::vertex*> verts;
+    for(int i = 0; i < 200; ++i)
+      verts.push_back(g.insert_vertex(i));
+    // directed, with a few vertices only reachable one way
+    for(int i = 0; i < 200; ++i) {
+      g.insert_edge(verts[i], verts[(i * 17 + 3) % 200], 1 + (i * 7) % 10);
+      if(i % 5 != 0)
+        g.insert_edge(verts[i], verts[(i + 1) % 200], 1 + (i * 3) % 4);
+    }
+
+    nostd::path_workspace<weighted> full, work;
+    nostd::landmarks<weighted> marks(g, 4);
+    assert(marks.size() == 4);
+
+    // asking for every vertex, or more, gives each one exactly once
+    nostd::landmarks<weighted> all(g, 250);
+    std::set<weighted::vertex*> distinct;
+    for(size_t l = 0; l < all.size(); ++l)
+      distinct.insert(all.landmark(l));
+    assert(all.size() == 200 && distinct.size() == 200);
+
+    for(int s = 0; s < 200; s += 13) {
+      nostd::dijkstra_search(g, verts[s], (weighted::vertex*)nullptr, full);
+      for(int t = 0; t < 200; t += 7) {
+        unsigned expected = full.forward.distance(verts[t]);
+
+        unsigned d1 = nostd::dijkstra_search(g, verts[s], verts[t], work);
+        assert(d1 == expected);
+        unsigned d2 = nostd::bidirectional_dijkstra_search(g, verts[s], verts[t], work);
+        assert(d2 == expected);
+        if(expected != full.forward.infinity()) {
+          // the path is connected and as long as the distance
+          auto path = work.path();
+          assert(path.front() == verts[s] && path.back() == verts[t]);
+          unsigned length = 0;
+          for(size_t i = 0; i + 1 < path.size(); ++i)
+            length += (*g.find_edge(path[i], path[i + 1]))->property();
+          assert(length == expected);
+        }
+        else
+          assert(work.path().empty());
+
+        unsigned d3 = nostd::astar_search(g, verts[s], verts[t], work, marks.to(verts[t]));
+        assert(d3 == expected && marks.lower_bound(verts[s], verts[t]) <= expected);
+        unsigned d4 = nostd::astar_search(g, verts[s], verts[t], work,
+                                          [](const weighted::vertex*) { return 0u; });
+        assert(d4 == expected);
+      }
+    }
+  }
+
+  void traversal_ranges() {
+    graph<int, int> g;
+    std::vector<graph<int, int>::vertex*> verts;
+    for(int i = 0; i < 300; ++i)
+      verts.push_back(g.insert_vertex(i));
+    for(int i = 0; i < 300; ++i) {
+      g.insert_edge(verts[i], verts[(i * 11 + 7) % 300], 1);
+      g.insert_edge(verts[i], verts[(i + 1) % 300], 1);
+    }
+
+    // same orders as the visitor based searches
+    order_visitor bfs_order, dfs_order;
+    nostd::breath_first_search(g, verts[0], bfs_order);
+    nostd::depth_first_search(g, verts[0], dfs_order);
+
+    std::vector<int> lazy_bfs, lazy_dfs;
+    for(auto v : nostd::bfs_range(g, verts[0]))
+      lazy_bfs.push_back(v->property());
+    for(auto v : nostd::dfs_range(g, verts[0]))
+      lazy_dfs.push_back(v->property());
+    assert(lazy_bfs == bfs_order.data() && lazy_dfs == dfs_order.data());
+
+    // stopping early scans only the vertices moved past
+    nostd::traversal_workspace<graph<int, int>> work;
+    nostd::bfs_range<graph<int, int>> nearest(g, verts[0], work);
+    size_t taken = 0;
+    uint32_t depth = 0;
+    for(auto iter = nearest.begin(); iter != nearest.end(); ++iter) {
+      depth = iter.depth();
+      if(++taken == 10)
+        break;
+    }
+    assert(nearest.expanded() == 9 && depth <= 4);
+
+    // a reused workspace does not allocate again
+    for(auto v : nostd::dfs_range(g, verts[0], work))
+      assert(v != nullptr);
+    size_t before = allocation_count();
+    taken = 0;
+    for(auto v : nostd::dfs_range(g, verts[5], work))
+      taken += (v != nullptr);
+    for(auto v : nostd::bfs_range(g, verts[5], work))
+      taken += (v != nullptr);
+    assert(allocation_count() == before && taken == 2 * lazy_bfs.size());
+  }
+
+  void views() {
+    typedef graph<int, unsigned> weighted;
+    weighted g;
+    std::vector<weighted::vertex*> verts;
+    for(int i = 0; i < 100; ++i)
+      verts.push_back(g.insert_vertex(i));
+    for(int i = 0; i < 100; ++i) {
+      g.insert_edge(verts[i], verts[(i * 7 + 1) % 100], i % 4);
+      g.insert_edge(verts[i], verts[(i + 1) % 100], 1 + i % 3);
+    }
+
+    // edges above a threshold, against a copy holding only those edges
+    auto heavy = [](const weighted::edge* _e) { return _e->property() >= 2; };
+    nostd::filtered_graph<weighted, nostd::keep_all, decltype(heavy)>
+        filtered(g, nostd::keep_all(), heavy);
+    weighted copy;
+    std::vector<weighted::vertex*> copied;
+    for(int i = 0; i < 100; ++i)
+      copied.push_back(copy.insert_vertex(i));
+    size_t kept = 0;
+    for(size_t i = 0; i < g.num_edges(); ++i) {
+      auto e = g.edge_at(i);
+      if(heavy(e)) {
+        copy.insert_edge(copied[e->source()->index()], copied[e->target()->index()],
+                         e->property());
+        ++kept;
+      }
+    }
+
+    std::vector<int> view_depth(100, -1), copy_depth(100, -1);
+    nostd::bfs_range<decltype(filtered)> lazy(filtered, verts[0]);
+    for(auto iter = lazy.begin(); iter != lazy.end(); ++iter)
+      view_depth[(*iter)->property()] = iter.depth();
+    nostd::bfs_range<weighted> reference(copy, copied[0]);
+    for(auto iter = reference.begin(); iter != reference.end(); ++iter)
+      copy_depth[(*iter)->property()] = iter.depth();
+    assert(view_depth == copy_depth);
+
+    count_visitor counter;
+    nostd::breath_first_search(filtered, verts[0], counter);
+    size_t reached = 0;
+    for(auto d : view_depth)
+      reached += (d >= 0);
+    assert(size_t(counter.discovered) == reached);
+    assert(nostd::csr_graph<decltype(filtered)>(filtered).num_edges() == kept);
+
+    // even vertices only
+    nostd::vertex_bitmap even(g.num_vertices());
+    for(auto v : verts)
+      if(v->property() % 2 == 0)
+        even.set(v);
+    nostd::induced_subgraph<weighted> sub(g, even);
+    assert(sub.contains(verts[4]) && !sub.contains(verts[5]));
+    for(auto v : nostd::dfs_range(sub, verts[0]))
+      assert(v->property() % 2 == 0);
+
+    // the searches without a root start at the view's first vertex
+    assert(std::distance(sub.begin(), sub.end()) == 50);
+    order_visitor from_first;
+    nostd::depth_first_search(sub, from_first);
+    assert(!from_first.data().empty() && from_first.data()[0] == (*sub.begin())->property());
+    for(auto p : from_first.data())
+      assert(p % 2 == 0);
+    count_visitor everywhere;
+    nostd::breath_first_search(nostd::reverse_graph<weighted>(g), everywhere);
+    assert(everywhere.discovered > 0);
+
+    // reversed, against searches on the graph itself
+    nostd::reverse_graph<weighted> reversed(g);
+    std::vector<bool> reaches(100, false);
+    for(auto v : nostd::dfs_range(reversed, verts[3]))
+      reaches[v->property()] = true;
+    nostd::path_workspace<weighted> forward;
+    nostd::path_workspace<nostd::reverse_graph<weighted>> backward;
+    for(int i = 0; i < 100; ++i) {
+      unsigned d = nostd::dijkstra_search(g, verts[i], verts[3], forward);
+      assert(reaches[i] == (d != forward.forward.infinity()));
+      assert(d == nostd::bidirectional_dijkstra_search(reversed, verts[3], verts[i], backward));
+      if(reaches[i]) {
+        auto path = backward.path();
+        assert(path.front() == verts[3] && path.back() == verts[i]);
+      }
+    }
+  }
+
+  void spanning_forest() {
+    typedef graph<int, int> weighted;
+    weighted g;
+    std::vector<weighted::vertex*> verts;
+    for(int i = 0; i < 600; ++i)
+      verts.push_back(g.insert_vertex(i));
+    // two components, even and odd vertices, with many equal weights,
+    // parallel connections and a few self loops
+    srand(7);
+    for(int i = 0; i < 3000; ++i) {
+      int a = rand() % 600;
+      int b = (rand() % 300) * 2 + a % 2;
+      g.insert_undirected(verts[a], verts[b], rand() % 20);
+    }
+    for(int i = 0; i < 600; i += 2)
+      g.insert_undirected(verts[i], verts[(i + 2) % 600], 50);
+    for(int i = 1; i < 600; i += 2)
+      g.insert_undirected(verts[i], verts[(i + 2) % 600], 50);
+
+    // plain Kruskal as reference
+    std::vector<weighted::edge*> sorted;
+    for(size_t i = 0; i < g.num_edges(); ++i)
+      sorted.push_back(g.edge_at(i));
+    std::sort(sorted.begin(), sorted.end(), [](weighted::edge* _a, weighted::edge* _b) {
+      if(_a->property() != _b->property())
+        return _a->property() < _b->property();
+      return _a->index() < _b->index();
+    });
+    std::vector<size_t> parent(600);
+    for(size_t i = 0; i < 600; ++i)
+      parent[i] = i;
+    auto root = [&](size_t _v) {
+      while(parent[_v] != _v)
+        _v = parent[_v];
+      return _v;
+    };
+    long expected = 0;
+    std::set<weighted::edge*> reference;
+    for(auto e : sorted) {
+      size_t a = root(e->source()->index()), b = root(e->target()->index());
+      if(a != b) {
+        parent[a] = b;
+        expected += e->property();
+        reference.insert(e);
+      }
+    }
+    assert(reference.size() == 598);
+
+    nostd::executor exec(2);
+    std::vector<std::vector<weighted::edge*>> forests = {
+      nostd::boruvka_spanning_forest(g),
+      nostd::boruvka_spanning_forest(g, &exec),
+      nostd::filter_kruskal_spanning_forest(g),
+      nostd::filter_kruskal_spanning_forest(g, &exec),
+      // small base case so the heavy sides are filtered
+      nostd::filter_kruskal_spanning_forest(g, &exec, nostd::edge_weight(), 64)
+    };
+    for(auto& forest : forests) {
+      // ties break by index, so every algorithm finds the same forest
+      assert(std::set<weighted::edge*>(forest.begin(), forest.end()) == reference);
+      assert(forest.size() == reference.size());
+    }
+
+    weighted tree = nostd::spanning_forest_graph(g, forests[0]);
+    assert(tree.num_vertices() == 600);
+    assert(tree.num_edges() == 2 * 598);
+    long total = 0;
+    for(size_t i = 0; i < tree.num_edges(); ++i)
+      total += tree.edge_at(i)->property();
+    assert(total == 2 * expected);
+    size_t reached = 0;
+    for(auto v : nostd::bfs_range<weighted>(tree, tree.vertex_at(0)))
+      reached += (v->property() % 2 == 0);
+    assert(reached == 300);
+
+    // a view holding only the even component
+    nostd::vertex_bitmap even(g.num_vertices());
+    for(int i = 0; i < 600; i += 2)
+      even.set(verts[i]);
+    nostd::induced_subgraph<weighted> sub(g, even);
+    auto half = nostd::boruvka_spanning_forest(sub, &exec);
+    assert(half.size() == 299);
+    for(auto e : half)
+      assert(reference.count(e) == 1);
+  }
+
+  void dynamic() {
+    typedef graph<int, unsigned> weighted;
+    weighted g;
+    std::vector<weighted::vertex*> verts;
+    for(int i = 0; i < 300; ++i)
+      verts.push_back(g.insert_vertex(i));
+    srand(11);
+    for(int i = 0; i < 400; ++i)
+      g.insert_edge(verts[rand() % 300], verts[rand() % 300], 1 + rand() % 9);
+
+    nostd::executor exec(2);
+    nostd::dynamic_connectivity<weighted> components(g, &exec);
+    nostd::dynamic_shortest_paths<weighted> paths(g, verts[0]);
+    nostd::dynamic_bfs<weighted> hops(g, verts[0]);
+
+    // against recomputing from scratch after every batch
+    nostd::path_workspace<weighted> full;
+    auto check = [&]() {
+      nostd::dijkstra_search(g, verts[0], (weighted::vertex*)nullptr, full);
+      std::vector<uint32_t> depth(g.num_vertices(), nostd::dynamic_bfs<weighted>::infinity());
+      nostd::bfs_range<weighted> reference(g, verts[0]);
+      for(auto iter = reference.begin(); iter != reference.end(); ++iter)
+        depth[(*iter)->index()] = iter.depth();
+      nostd::union_find sets(g.num_vertices());
+      size_t count = g.num_vertices();
+      for(size_t i = 0; i < g.num_edges(); ++i)
+        count -= sets.unite(g.edge_at(i)->source()->index(), g.edge_at(i)->target()->index());
+
+      assert(components.num_components() == count);
+      for(size_t i = 0; i < g.num_vertices(); ++i) {
+        auto v = g.vertex_at(i);
+        assert(components.connected(v, verts[0]) == sets.same(i, verts[0]->index()));
+        unsigned d = full.forward.distance(v);
+        assert(paths.distance(v) == (d == full.forward.infinity() ? paths.infinity() : d));
+        assert(hops.distance(v) == depth[i]);
+      }
+    };
+    check();
+
+    // batches of inserts and erases; only inserts never rebuild
+    for(int batch = 0; batch < 30; ++batch) {
+      for(int i = 0; i < 10; ++i)
+        g.insert_edge(verts[rand() % 300], verts[rand() % 300], 1 + rand() % 9);
+      if(batch % 2 == 1)
+        for(int i = 0; i < 15; ++i)
+          g.erase_edge(g.edge_at(rand() % g.num_edges()));
+      check();
+      // repairs stay local
+      assert(paths.rebuilds() == 1 && hops.rebuilds() == 1);
+      assert(paths.touched() < g.num_vertices());
+    }
+
+    // an insert and erase of the same edge inside one batch
+    auto e = g.insert_edge(verts[0], verts[299], 1);
+    g.erase_edge(e);
+    check();
+    size_t rebuilds = components.rebuilds();
+
+    // erasing one of a parallel pair keeps the components
+    g.insert_undirected(verts[5], verts[6], 3);
+    assert(components.connected(verts[5], verts[6]));
+    g.erase_edge(*g.find_edge(verts[5], verts[6]));
+    check();
+    assert(components.rebuilds() == rebuilds);
+
+    // new vertices, then erasing vertices rebuilds
+    for(int i = 0; i < 20; ++i) {
+      auto v = g.insert_vertex(300 + i);
+      g.insert_edge(verts[i], v, 2);
+    }
+    check();
+    assert(paths.rebuilds() == 1);
+    g.erase_vertex(verts[150]);
+    check();
+    assert(paths.rebuilds() == 2);
+
+    // the source itself
+    g.erase_vertex(verts[0]);
+    assert(paths.source() == nullptr);
+    for(size_t i = 0; i < g.num_vertices(); ++i)
+      assert(paths.distance(g.vertex_at(i)) == paths.infinity());
+    g.clear();
+    assert(components.num_components() == 0);
+
+    // detaching an observer that is not attached is harmless
+    weighted other;
+    other.detach(&components);
+    g.detach(&components);
+    g.detach(&components);
+    g.insert_vertex(0);
+    assert(components.num_components() == 0);
+  }
+
+  void cores() {
+    graph<int, int> g;
+    std::vector<graph<int, int>::vertex*> verts;
+    for(int i = 0; i < 400; ++i)
+      verts.push_back(g.insert_vertex(i));
+    nostd::degree_index<graph<int, int>> degrees(g);
+
+    // a dense block for a deep core, a sparse rest, parallel edges and
+    // self loops
+    srand(5);
+    for(int i = 0; i < 40; ++i)
+      for(int j = i + 1; j < 40; ++j)
+        if(rand() % 3 != 0)
+          g.insert_undirected(verts[i], verts[j], 1);
+    for(int i = 0; i < 1200; ++i)
+      g.insert_edge(verts[rand() % 400], verts[rand() % 400], 1);
+    for(int i = 0; i < 10; ++i)
+      g.insert_edge(verts[i * 7], verts[i * 7], 1);
+
+    // the cached degrees follow inserts and erases of edges and vertices
+    auto check_degrees = [&]() {
+      for(size_t i = 0; i < g.num_vertices(); ++i) {
+        auto v = g.vertex_at(i);
+        assert(degrees.out_degree(v) == v->out_degree());
+        assert(degrees.in_degree(v) == v->in_degree());
+        assert(degrees.degree(v) == v->degree());
+      }
+      for(auto kind : {nostd::TOTAL_DEGREE, nostd::OUT_DEGREE, nostd::IN_DEGREE})
+        assert(degrees.histogram(kind) == nostd::degree_histogram(g, kind));
+    };
+    check_degrees();
+
+    // a parallel edge is a second entry in both adjacency sets
+    size_t before = verts[1]->out_degree();
+    auto first = g.insert_edge(verts[1], verts[2], 1);
+    auto second = g.insert_edge(verts[1], verts[2], 1);
+    assert(first != second && verts[1]->out_degree() == before + 2);
+    check_degrees();
+    g.erase_edge(first);
+    check_degrees();
+
+    for(int i = 0; i < 100; ++i)
+      g.erase_edge(g.edge_at(rand() % g.num_edges()));
+    g.erase_vertex(verts[399]);
+    g.erase_vertex(verts[100]);
+    check_degrees();
+
+    // cores by removing a vertex below k until none is left
+    auto naive = [&](nostd::degree_kind _kind) {
+      std::vector<uint32_t> core(g.num_vertices(), 0);
+      std::vector<char> removed(g.num_vertices(), 0);
+      size_t left = g.num_vertices();
+      for(uint32_t k = 0; left > 0; ++k) {
+        bool again = true;
+        while(again) {
+          again = false;
+          for(size_t i = 0; i < g.num_vertices(); ++i) {
+            if(removed[i])
+              continue;
+            uint32_t d = 0;
+            auto v = g.vertex_at(i);
+            if(_kind != nostd::IN_DEGREE)
+              for(auto e = v->out_begin(); e != v->out_end(); ++e)
+                d += !removed[(*e)->target()->index()];
+            if(_kind != nostd::OUT_DEGREE)
+              for(auto e = v->in_begin(); e != v->in_end(); ++e)
+                d += !removed[(*e)->source()->index()] || (*e)->source() == v;
+            if(d <= k) {
+              core[i] = k;
+              removed[i] = 1;
+              --left;
+              again = true;
+            }
+          }
+        }
+      }
+      return core;
+    };
+
+    nostd::executor exec(2);
+    nostd::vertex_property_map<uint32_t> serial, cached, parallel, single;
+    for(auto kind : {nostd::TOTAL_DEGREE, nostd::OUT_DEGREE, nostd::IN_DEGREE}) {
+      auto expected = naive(kind);
+      uint32_t top = nostd::core_numbers(g, serial, kind);
+      assert(top == *std::max_element(expected.begin(), expected.end()));
+      assert(nostd::core_numbers(degrees, cached, kind) == top);
+      assert(nostd::parallel_core_numbers(g, parallel, &exec, kind) == top);
+      assert(nostd::parallel_core_numbers(g, single, nullptr, kind) == top);
+      for(size_t i = 0; i < g.num_vertices(); ++i) {
+        assert(serial[i] == expected[i]);
+        assert(cached[i] == expected[i]);
+        assert(parallel[i] == expected[i]);
+        assert(single[i] == expected[i]);
+      }
+    }
+    assert(nostd::core_numbers(g, serial, nostd::OUT_DEGREE) >= 10);
+
+    // the dense block on its own
+    nostd::vertex_bitmap block(g.num_vertices());
+    for(int i = 0; i < 40; ++i)
+      block.set(verts[i]);
+    nostd::induced_subgraph<graph<int, int>> sub(g, block);
+    nostd::core_numbers(sub, serial);
+    nostd::parallel_core_numbers(sub, parallel, &exec);
+    for(size_t i = 0; i < g.num_vertices(); ++i) {
+      assert(serial[i] == parallel[i]);
+      if(!block.test(i))
+        assert(serial[i] == 0);
+    }
+
+    g.clear();
+    assert(degrees.histogram().empty());
+  }
+
+  void csr() {
+    graph<int, int> g;
+    std::vector<graph<int, int>::vertex*> verts;
+    for(int i = 0; i < 1000; ++i)
+      verts.push_back(g.insert_vertex(i));
+    for(int i = 0; i < 1000; ++i) {
+      g.insert_edge(verts[i], verts[(i + 1) % 1000], 1);
+      g.insert_edge(verts[i], verts[(i * 7 + 3) % 1000], 1);
+    }
+
+    // two fake nodes so the snapshot is split
+    nostd::numa_topology topo({{0}, {0}});
+    nostd::executor exec(2, true, topo);
+    nostd::csr_graph<graph<int, int>> c(g, &exec, topo);
+
+    assert(c.num_partitions() == 2 && c.num_edges() == 2000);
+    assert(c.get_partition(0).last == c.get_partition(1).first);
+    uint32_t split = c.get_partition(1).first;
+    assert(c.partition_of(0) == 0 && c.partition_of(split - 1) == 0 &&
+           c.partition_of(split) == 1 && c.partition_of(999) == 1);
+    auto n0 = c.neighbors(0);
+    assert(n0.size() == 2 && n0.begin()[0] == 1 && n0.begin()[1] == 3);
+
+    std::vector<uint32_t> serial, parallel;
+    nostd::breath_first_search(c, 0, serial);
+    nostd::breath_first_search(c, 0, parallel, &exec);
+    assert(serial == parallel && serial[1] == 1 && serial[10] == 2);
+  }
+
+  void reorder() {
+    graph<int, int> g;
+    std::vector<graph<int, int>::vertex*> verts;
+    for(int i = 0; i < 10; ++i)
+      verts.push_back(g.insert_vertex(i));
+    // a path visiting the indices out of order
+    int path[] = {3, 7, 0, 9, 5, 1, 8, 2, 6, 4};
+    for(int i = 0; i + 1 < 10; ++i)
+      g.insert_undirected(verts[path[i]], verts[path[i + 1]], 1);
+
+    auto perm = nostd::reorder(g, nostd::RCM_ORDER);
+    auto back = nostd::invert_permutation(perm);
+    for(int i = 0; i < 10; ++i)
+      assert(verts[i]->index() == perm[i] && back[perm[i]] == size_t(i));
+
+    // neighbors on the path are now neighbors in index order
+    for(int i = 0; i + 1 < 10; ++i) {
+      size_t a = verts[path[i]]->index(), b = verts[path[i + 1]]->index();
+      assert(a + 1 == b || b + 1 == a);
+    }
+
+    // on a view the first half of the path is one component, the rest
+    // isolated vertices
+    nostd::vertex_bitmap half(10);
+    for(int i = 0; i < 5; ++i)
+      half.set(verts[path[i]]);
+    nostd::induced_subgraph<graph<int, int>> view(g, half);
+    auto order = nostd::compute_order(view, nostd::BFS_ORDER);
+    std::vector<size_t> position = nostd::invert_permutation(order);
+    size_t lo = 10, hi = 0;
+    for(int i = 0; i < 5; ++i) {
+      lo = std::min(lo, position[verts[path[i]]->index()]);
+      hi = std::max(hi, position[verts[path[i]]->index()]);
+    }
+    assert(order.size() == 10 && hi - lo == 4);
+
+    nostd::reorder(g, nostd::DEGREE_ORDER);
+    assert(g.vertex_at(9)->degree() == 2);
+  }
+
+  void compressed() {
+    graph<int, int> g;
+    std::vector<graph<int, int>::vertex*> verts;
+    for(int i = 0; i < 70000; ++i)
+      verts.push_back(g.insert_vertex(i));
+    // one hub with large gaps between its neighbors, a ring for the rest
+    for(int i = 1; i < 70000; i += 97)
+      g.insert_edge(verts[0], verts[i], 1);
+    g.insert_edge(verts[0], verts[69999], 1);
+    for(int i = 1; i < 70000; ++i)
+      g.insert_edge(verts[i], verts[(i + 1) % 70000], 1);
+    // one, two and three byte gaps within a group of four
+    for(int i : {0, 302, 69990, 69991, 69992, 69993, 69999})
+      g.insert_edge(verts[2], verts[i], 1);
+
+    nostd::csr_graph<graph<int, int>> c(g);
+    nostd::compressed_graph<graph<int, int>> z(c);
+    assert(z.num_edges() == c.num_edges() && z.out_degree(0) > 128);
+
+    std::vector<uint32_t> mixed(z.out_degree(2));
+    z.decode(2, mixed.data());
+    auto adj2 = c.neighbors(2);
+    assert(mixed.size() == 8 && std::equal(adj2.begin(), adj2.end(), mixed.begin()));
+
+    std::vector<uint32_t> out(z.out_degree(0));
+    z.decode(0, out.data());
+    auto adj = c.neighbors(0);
+    assert(std::equal(adj.begin(), adj.end(), out.begin()));
+    assert(z.neighbor(0, 200) == adj.begin()[200]);
+    assert(z.has_edge(0, 97 * 150 + 1) && !z.has_edge(0, 97 * 150 + 2));
+    assert(z.has_edge(0, 69999) && !z.has_edge(1, 0));
+
+    std::vector<uint32_t> plain, packed;
+    nostd::breath_first_search(c, 0, plain);
+    nostd::executor exec(2);
+    nostd::breath_first_search(z, 0, packed, &exec);
+    assert(plain == packed);
+  }
+
+#ifdef NOSTD_INSTRUMENT
+  void instrumentation() {
+    auto& stats = nostd::instrument::stats();
+    stats.reset();
+    stats.hardware_counters = true;
+
+    graph<int, int> g;
+    auto v1 = g.insert_vertex(1);
+    auto v2 = g.insert_vertex(2);
+    auto v3 = g.insert_vertex(3);
+    g.insert_edge(v1, v2, 1);
+    g.insert_edge(v1, v3, 1);
+    g.find_vertex(v2);
+
+    count_visitor vis;
+    nostd::breath_first_search(g, v1, vis);
+
+    assert(stats.op(nostd::instrument::INSERT_VERTEX).calls == 3);
+    assert(stats.op(nostd::instrument::INSERT_EDGE).calls == 2);
+    assert(stats.op(nostd::instrument::FIND_VERTEX).calls == 1);
+
+    // only the outer one of nested operations counts
+    {
+      NOSTD_TIME_OP(INSERT_EDGE);
+      g.find_vertex(v3);
+    }
+    assert(stats.op(nostd::instrument::INSERT_EDGE).calls == 3);
+    assert(stats.op(nostd::instrument::FIND_VERTEX).calls == 1);
+
+    auto& bfs = stats.algo(nostd::instrument::BFS);
+    assert(bfs.runs == 1 && bfs.vertices_visited == 3 &&
+           bfs.edges_traversed == 2 && bfs.frontier.percentile(1.0) == 3);
+
+    // the workers' local edge counts all reach the total
+    graph<int, int> ring;
+    std::vector<graph<int, int>::vertex*> verts;
+    for(int i = 0; i < 5000; ++i)
+      verts.push_back(ring.insert_vertex(i));
+    for(int i = 0; i < 5000; ++i)
+      ring.insert_undirected(verts[i], verts[(i + 1) % 5000], 1);
+    nostd::executor exec(3);
+    count_visitor ring_vis;
+    nostd::breath_first_search(ring, verts[0], ring_vis, &exec);
+    assert(bfs.runs == 2 && bfs.edges_traversed == 2 + 10000);
+    stats.report(std::cout);
+  }
+#endif
+
   void dfs() {
+    graph<int, int> g;
 
+    auto v1 = g.insert_vertex(1);
+    auto v2 = g.insert_vertex(2);
+    auto v3 = g.insert_vertex(3);
+    auto v4 = g.insert_vertex(4);
+
+    g.insert_edge(v1, v2, 1);
+    g.insert_edge(v1, v3, 1);
+    g.insert_edge(v2, v4, 1);
+    g.insert_edge(v4, v1, 1);
+
+    order_visitor vis;
+    nostd::depth_first_search(g, v1, vis);
+
+    auto& order = vis.data();
+    assert(order.size() == 4 && order[0] == 1 && vis.tree_edges == 3);
+    // v4 is only reachable through v2, so it directly follows it
+    for(size_t i = 0; i < order.size(); ++i)
+      if(order[i] == 2)
+        assert(order[i + 1] == 4);
   }
 
   void bfs() {
+    graph<int, int> g;
+    std::vector<graph<int, int>::vertex*> verts;
+    for(int i = 0; i < 100; ++i)
+      verts.push_back(g.insert_vertex(i));
+    for(int i = 0; i < 100; ++i) {
+      g.insert_edge(verts[i], verts[(i + 1) % 100], 1);
+      g.insert_edge(verts[i], verts[(i * 7) % 100], 1);
+    }
 
-  }
+    order_visitor serial;
+    nostd::breath_first_search(g, verts[0], serial);
+    assert(serial.data().size() == 100 && serial.data()[0] == 0 &&
+           serial.tree_edges == 99);
 
+    nostd::executor exec(4);
+    count_visitor parallel;
+    nostd::breath_first_search(g, verts[0], parallel, &exec);
+    assert(parallel.discovered == 100 && parallel.tree_edges == 99);
+  }
+#endif
 };
 
-int main() {
+int main(int argc, char** argv) {
   graph_test gtest;
-  if(gtest.run())
-    std::cout << "Test Successful\n";
-  return 0;
+  return run_suite(gtest, argc, argv);
 }
@@ -0,0 +1,346 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @name Graph Views
+/// @group Graph
+///
+/// @note Views present part of a graph, or the graph reversed, through the
+///       same adjacency interface as nostd::graph without copying it:
+///
+///           filtered_graph   - vertices and edges passing two predicates
+///           induced_subgraph - vertices set in a vertex_bitmap and the
+///                              edges between them
+///           reverse_graph    - every edge reversed; out and in lists swap
+///
+///       The algorithms accept a view anywhere they accept a graph, and
+///       views nest. Predicates are template parameters, so they are
+///       inlined into the iteration. A view holds a reference to the
+///       graph, which must outlive it; changes to the graph show through.
+///
+///       Vertex and edge indices are those of the underlying graph, so
+///       property maps can be shared between a graph and its views.
+///       Likewise num_vertices(), num_edges(), vertex_at() and edge_at()
+///       cover the underlying index space; contains() tells whether a
+///       vertex or edge is part of the view. begin() and end() iterate the
+///       vertices of the view only, in the order of the graph's own
+///       begin(). out_degree() and in_degree() of a filtered view count the
+///       passing edges, in O(degree) rather than O(1).
+///
+///////////////////////////////////////////////////////////////////////////////
+#ifndef GRAPH_VIEW_H
+#define GRAPH_VIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace nostd {
+
+  /// @brief Predicate accepting everything
+  struct keep_all {
+    template<typename T>
+    bool operator()(const T*) const { return true; }
+  };
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief View of the vertices passing VertexPred and the edges passing
+  ///        EdgePred whose endpoints both pass VertexPred.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename GraphType, typename VertexPred = keep_all,
+           typename EdgePred = keep_all>
+  class filtered_graph {
+    public:
+      /// @name Graph Typedefs
+      /// @{
+      typedef GraphType graph_type;
+      typedef typename GraphType::vertex vertex;
+      typedef typename GraphType::edge edge;
+      typedef typename GraphType::vertex_type vertex_type;
+      typedef typename GraphType::edge_type edge_type;
+      typedef typename GraphType::adj_iterator base_iterator;
+      typedef typename GraphType::const_vertex_iterator base_vertex_iterator;
+
+      /// @brief Skips the vertices that are not in the view
+      class const_vertex_iterator {
+        public:
+          typedef std::forward_iterator_tag iterator_category;
+          typedef vertex* value_type;
+          typedef std::ptrdiff_t difference_type;
+          typedef vertex* const* pointer;
+          typedef vertex* const& reference;
+
+          const_vertex_iterator() {}
+          const_vertex_iterator(const filtered_graph* _view, base_vertex_iterator _iter,
+                                base_vertex_iterator _end):
+                                m_view(_view), m_iter(_iter), m_end(_end) {
+            skip();
+          }
+
+          reference operator*() const { return *m_iter; }
+
+          const_vertex_iterator& operator++() {
+            ++m_iter;
+            skip();
+            return *this;
+          }
+
+          const_vertex_iterator operator++(int) {
+            const_vertex_iterator temp = *this;
+            ++*this;
+            return temp;
+          }
+
+          bool operator==(const const_vertex_iterator& _other) const { return m_iter == _other.m_iter; }
+          bool operator!=(const const_vertex_iterator& _other) const { return m_iter != _other.m_iter; }
+
+        private:
+          void skip() {
+            while(m_iter != m_end && !m_view->contains(*m_iter))
+              ++m_iter;
+          }
+
+          const filtered_graph* m_view;
+          base_vertex_iterator m_iter;
+          base_vertex_iterator m_end;
+      };
+
+      /// @brief Skips the adjacent edges that are not in the view
+      class adj_iterator {
+        public:
+          typedef std::forward_iterator_tag iterator_category;
+          typedef edge* value_type;
+          typedef std::ptrdiff_t difference_type;
+          typedef edge* const* pointer;
+          typedef edge* const& reference;
+
+          adj_iterator() {}
+          adj_iterator(const filtered_graph* _view, base_iterator _iter,
+                       base_iterator _end, bool _out):
+                       m_view(_view), m_iter(_iter), m_end(_end), m_out(_out) {
+            skip();
+          }
+
+          reference operator*() const { return *m_iter; }
+
+          adj_iterator& operator++() {
+            ++m_iter;
+            skip();
+            return *this;
+          }
+
+          adj_iterator operator++(int) {
+            adj_iterator temp = *this;
+            ++*this;
+            return temp;
+          }
+
+          bool operator==(const adj_iterator& _other) const { return m_iter == _other.m_iter; }
+          bool operator!=(const adj_iterator& _other) const { return m_iter != _other.m_iter; }
+
+        private:
+          void skip() {
+            while(m_iter != m_end && !m_view->passes(*m_iter, m_out))
+              ++m_iter;
+          }
+
+          const filtered_graph* m_view;
+          base_iterator m_iter;
+          base_iterator m_end;
+          bool m_out;     // out list, so the target is the far endpoint
+      };
+      /// @}
+
+      /// @name constructors
+      /// @{
+      filtered_graph(const GraphType& _graph, VertexPred _vertex_pred = VertexPred(),
+                     EdgePred _edge_pred = EdgePred()):
+                     m_graph(&_graph), m_vertex_pred(_vertex_pred),
+                     m_edge_pred(_edge_pred) {}
+      /// @}
+
+      /// @name Graph Statistics
+      /// @{
+      size_t num_vertices() const { return m_graph->num_vertices(); }
+      size_t num_edges() const { return m_graph->num_edges(); }
+
+      bool contains(const vertex* _vert) const { return m_vertex_pred(_vert); }
+
+      bool contains(edge* _edge) const {
+        return m_edge_pred(_edge) && m_vertex_pred(m_graph->source(_edge)) &&
+               m_vertex_pred(m_graph->target(_edge));
+      }
+
+      const GraphType& base() const { return *m_graph; }
+      /// @}
+
+      /// @name Vertex Iteration
+      /// @{
+      const_vertex_iterator begin() const {
+        return const_vertex_iterator(this, m_graph->begin(), m_graph->end());
+      }
+      const_vertex_iterator end() const {
+        return const_vertex_iterator(this, m_graph->end(), m_graph->end());
+      }
+      /// @}
+
+      /// @name Index Access
+      /// @{
+      vertex* vertex_at(size_t _index) const { return m_graph->vertex_at(_index); }
+      edge* edge_at(size_t _index) const { return m_graph->edge_at(_index); }
+      /// @}
+
+      /// @name Adjacency
+      /// @{
+      adj_iterator out_begin(vertex* _vert) const {
+        return adj_iterator(this, m_graph->out_begin(_vert), m_graph->out_end(_vert), true);
+      }
+      adj_iterator out_end(vertex* _vert) const {
+        return adj_iterator(this, m_graph->out_end(_vert), m_graph->out_end(_vert), true);
+      }
+
+      adj_iterator in_begin(vertex* _vert) const {
+        return adj_iterator(this, m_graph->in_begin(_vert), m_graph->in_end(_vert), false);
+      }
+      adj_iterator in_end(vertex* _vert) const {
+        return adj_iterator(this, m_graph->in_end(_vert), m_graph->in_end(_vert), false);
+      }
+
+      /// @brief Walks the adjacency list, O(degree)
+      size_t out_degree(vertex* _vert) const {
+        return std::distance(out_begin(_vert), out_end(_vert));
+      }
+      /// @brief Walks the adjacency list, O(degree)
+      size_t in_degree(vertex* _vert) const {
+        return std::distance(in_begin(_vert), in_end(_vert));
+      }
+
+      vertex* source(edge* _edge) const { return m_graph->source(_edge); }
+      vertex* target(edge* _edge) const { return m_graph->target(_edge); }
+      /// @}
+
+    private:
+      // edges are only reached from a vertex in the view, so only the far
+      // endpoint needs checking
+      bool passes(edge* _edge, bool _out) const {
+        return m_edge_pred(_edge) &&
+               m_vertex_pred(_out ? m_graph->target(_edge) : m_graph->source(_edge));
+      }
+
+      const GraphType* m_graph;
+      VertexPred m_vertex_pred;
+      EdgePred m_edge_pred;
+  };
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief One bit per vertex index.
+  /////////////////////////////////////////////////////////////////////////////
+  class vertex_bitmap {
+    public:
+      vertex_bitmap(size_t _size = 0): m_bits((_size + 63) / 64, 0) {}
+
+      template<typename Vertex>
+      bool test(const Vertex* _vert) const { return test(_vert->index()); }
+      bool test(size_t _index) const {
+        return (m_bits[_index / 64] >> (_index % 64)) & 1;
+      }
+
+      template<typename Vertex>
+      void set(const Vertex* _vert) { set(_vert->index()); }
+      void set(size_t _index) { m_bits[_index / 64] |= uint64_t(1) << (_index % 64); }
+
+      template<typename Vertex>
+      void reset(const Vertex* _vert) { reset(_vert->index()); }
+      void reset(size_t _index) { m_bits[_index / 64] &= ~(uint64_t(1) << (_index % 64)); }
+
+    private:
+      std::vector<uint64_t> m_bits;
+  };
+
+  /// @brief Vertex predicate testing membership in a vertex_bitmap
+  class bitmap_filter {
+    public:
+      bitmap_filter(const vertex_bitmap& _bits): m_bits(&_bits) {}
+
+      template<typename Vertex>
+      bool operator()(const Vertex* _vert) const { return m_bits->test(_vert); }
+
+    private:
+      const vertex_bitmap* m_bits;
+  };
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief Subgraph induced by the vertices set in a bitmap. The bitmap is
+  ///        referenced, not copied; setting or clearing bits changes the view.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename GraphType>
+  class induced_subgraph : public filtered_graph<GraphType, bitmap_filter> {
+    public:
+      induced_subgraph(const GraphType& _graph, const vertex_bitmap& _vertices):
+          filtered_graph<GraphType, bitmap_filter>(_graph, bitmap_filter(_vertices)) {}
+  };
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief The graph with every edge reversed.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename GraphType>
+  class reverse_graph {
+    public:
+      /// @name Graph Typedefs
+      /// @{
+      typedef GraphType graph_type;
+      typedef typename GraphType::vertex vertex;
+      typedef typename GraphType::edge edge;
+      typedef typename GraphType::vertex_type vertex_type;
+      typedef typename GraphType::edge_type edge_type;
+      typedef typename GraphType::adj_iterator adj_iterator;
+      typedef typename GraphType::const_vertex_iterator const_vertex_iterator;
+      /// @}
+
+      /// @name constructors
+      /// @{
+      reverse_graph(const GraphType& _graph): m_graph(&_graph) {}
+      /// @}
+
+      /// @name Graph Statistics
+      /// @{
+      size_t num_vertices() const { return m_graph->num_vertices(); }
+      size_t num_edges() const { return m_graph->num_edges(); }
+
+      bool contains(const vertex* _vert) const { return m_graph->contains(_vert); }
+      bool contains(edge* _edge) const { return m_graph->contains(_edge); }
+
+      const GraphType& base() const { return *m_graph; }
+      /// @}
+
+      /// @name Vertex Iteration
+      /// @{
+      const_vertex_iterator begin() const { return m_graph->begin(); }
+      const_vertex_iterator end() const { return m_graph->end(); }
+      /// @}
+
+      /// @name Index Access
+      /// @{
+      vertex* vertex_at(size_t _index) const { return m_graph->vertex_at(_index); }
+      edge* edge_at(size_t _index) const { return m_graph->edge_at(_index); }
+      /// @}
+
+      /// @name Adjacency
+      /// @{
+      adj_iterator out_begin(vertex* _vert) const { return m_graph->in_begin(_vert); }
+      adj_iterator out_end(vertex* _vert) const { return m_graph->in_end(_vert); }
+
+      adj_iterator in_begin(vertex* _vert) const { return m_graph->out_begin(_vert); }
+      adj_iterator in_end(vertex* _vert) const { return m_graph->out_end(_vert); }
+
+      size_t out_degree(vertex* _vert) const { return m_graph->in_degree(_vert); }
+      size_t in_degree(vertex* _vert) const { return m_graph->out_degree(_vert); }
+
+      vertex* source(edge* _edge) const { return m_graph->target(_edge); }
+      vertex* target(edge* _edge) const { return m_graph->source(_edge); }
+      /// @}
+
+    private:
+      const GraphType* m_graph;
+  };
+}
+
+#endif // GRAPH_VIEW_H
@@ -0,0 +1,369 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @name Instrumentation
+/// @group Graph
+///
+/// @note Opt in counters for the graph hot paths. Define NOSTD_INSTRUMENT
+///       before including any graph header to turn them on; without it the
+///       macros below expand to nothing and none of this header is
+///       compiled.
+///
+///       Collected while enabled:
+///           per operation (insert/erase/find of vertices and edges) call
+///           counts and log2 latency histograms in nanoseconds; an
+///           operation made inside another one, like the find_vertex of
+///           a descriptor graph's insert_edge, is not counted on its own,
+///
+///           per algorithm run counts, vertices visited, edges traversed,
+///           a log2 histogram of frontier sizes and the wall time.
+///
+///       On linux the algorithms can also read cache and branch misses
+///       through perf_event_open; turn that on at run time with
+///       nostd::instrument::stats().hardware_counters = true. The events
+///       only count the thread that started the algorithm.
+///
+///       All counters are process wide; print them with
+///       nostd::instrument::stats().report(std::cout). Parallel loops count
+///       into a local with NOSTD_ALGO_LOCAL_EDGES and NOSTD_ALGO_ADD_EDGES,
+///       which adds to the shared counter once when its scope ends, so the
+///       workers do not all hit one cache line per edge.
+///
+///////////////////////////////////////////////////////////////////////////////
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#ifdef NOSTD_INSTRUMENT
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <ostream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace nostd {
+  namespace instrument {
+
+    enum Operation { INSERT_VERTEX, INSERT_EDGE, ERASE_VERTEX, ERASE_EDGE,
+                     FIND_VERTEX, FIND_EDGE, NUM_OPERATIONS };
+
+    enum Algorithm { BFS, DFS, MS_BFS, SHORTEST_PATH, SPANNING_FOREST,
+                     CORE_DECOMPOSITION, NUM_ALGORITHMS };
+
+    static const int NUM_BUCKETS = 64;
+
+    /// @brief Log2 histogram; bucket b counts values in [2^(b-1), 2^b).
+    class histogram {
+      public:
+        histogram() {
+          for(auto& b : m_buckets)
+            b.store(0, std::memory_order_relaxed);
+        }
+
+        void add(uint64_t _x) {
+          int bucket = (_x == 0) ? 0 : 64 - __builtin_clzll(_x);
+          if(bucket >= NUM_BUCKETS)
+            bucket = NUM_BUCKETS - 1;
+          m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        uint64_t bucket(int _b) const {
+          return m_buckets[_b].load(std::memory_order_relaxed);
+        }
+
+        /// @return Upper bound of the bucket holding the _p'th percentile,
+        ///         _p in [0, 1].
+        uint64_t percentile(double _p) const {
+          uint64_t total = 0;
+          for(int b = 0; b < NUM_BUCKETS; ++b)
+            total += bucket(b);
+          uint64_t seen = 0;
+          for(int b = 0; b < NUM_BUCKETS; ++b) {
+            seen += bucket(b);
+            if(total > 0 && seen >= _p * total)
+              return (b == 0) ? 0 : (uint64_t(1) << b) - 1;
+          }
+          return 0;
+        }
+
+        void reset() {
+          for(auto& b : m_buckets)
+            b.store(0, std::memory_order_relaxed);
+        }
+
+      private:
+        std::atomic<uint64_t> m_buckets[NUM_BUCKETS];
+    };
+
+    struct operation_stats {
+      std::atomic<uint64_t> calls{0};
+      std::atomic<uint64_t> total_ns{0};
+      histogram latency;
+    };
+
+    struct algorithm_stats {
+      std::atomic<uint64_t> runs{0};
+      std::atomic<uint64_t> vertices_visited{0};
+      std::atomic<uint64_t> edges_traversed{0};
+      std::atomic<uint64_t> total_ns{0};
+      std::atomic<uint64_t> cache_misses{0};
+      std::atomic<uint64_t> branch_misses{0};
+      histogram frontier;
+    };
+
+    /////////////////////////////////////////////////////////////////////////
+    /// @brief Every counter of the process.
+    /////////////////////////////////////////////////////////////////////////
+    class registry {
+      public:
+        operation_stats& op(Operation _op) { return m_ops[_op]; }
+        algorithm_stats& algo(Algorithm _algo) { return m_algos[_algo]; }
+
+        void reset() {
+          for(auto& o : m_ops) {
+            o.calls = 0;
+            o.total_ns = 0;
+            o.latency.reset();
+          }
+          for(auto& a : m_algos) {
+            a.runs = 0;
+            a.vertices_visited = 0;
+            a.edges_traversed = 0;
+            a.total_ns = 0;
+            a.cache_misses = 0;
+            a.branch_misses = 0;
+            a.frontier.reset();
+          }
+        }
+
+        void report(std::ostream& _out) {
+          static const char* op_names[] = {"insert_vertex", "insert_edge",
+                                           "erase_vertex", "erase_edge",
+                                           "find_vertex", "find_edge"};
+          static const char* algo_names[] = {"bfs", "dfs", "ms_bfs",
+                                             "shortest_path", "spanning_forest",
+                                             "core_decomposition"};
+
+          for(int i = 0; i < NUM_OPERATIONS; ++i) {
+            operation_stats& o = m_ops[i];
+            if(o.calls == 0)
+              continue;
+            _out << op_names[i] << ": calls " << o.calls
+                 << " mean_ns " << o.total_ns / o.calls
+                 << " p50_ns <= " << o.latency.percentile(0.5)
+                 << " p99_ns <= " << o.latency.percentile(0.99) << "\n";
+          }
+          for(int i = 0; i < NUM_ALGORITHMS; ++i) {
+            algorithm_stats& a = m_algos[i];
+            if(a.runs == 0)
+              continue;
+            _out << algo_names[i] << ": runs " << a.runs
+                 << " vertices " << a.vertices_visited
+                 << " edges " << a.edges_traversed
+                 << " total_ms " << a.total_ns / 1e6
+                 << " max_frontier <= " << a.frontier.percentile(1.0);
+            if(hardware_counters)
+              _out << " cache_misses " << a.cache_misses
+                   << " branch_misses " << a.branch_misses;
+            _out << "\n";
+          }
+        }
+
+        bool hardware_counters{false};   // read perf events around algorithms
+
+      private:
+        operation_stats m_ops[NUM_OPERATIONS];
+        algorithm_stats m_algos[NUM_ALGORITHMS];
+    };
+
+    inline registry& stats() {
+      static registry r;
+      return r;
+    }
+
+    inline uint64_t now_ns() {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /// @brief Times the enclosing scope as one call of an operation,
+    ///        unless the thread is already inside a timed operation.
+    class operation_timer {
+      public:
+        operation_timer(Operation _op): m_op(_op), m_outer(depth()++ == 0),
+                                        m_start(m_outer ? now_ns() : 0) {}
+
+        ~operation_timer() {
+          --depth();
+          if(!m_outer)
+            return;
+          uint64_t ns = now_ns() - m_start;
+          operation_stats& o = stats().op(m_op);
+          o.calls.fetch_add(1, std::memory_order_relaxed);
+          o.total_ns.fetch_add(ns, std::memory_order_relaxed);
+          o.latency.add(ns);
+        }
+
+      private:
+        static int& depth() {
+          static thread_local int d = 0;
+          return d;
+        }
+
+        Operation m_op;
+        bool m_outer;
+        uint64_t m_start;
+    };
+
+    /// @brief Count private to one thread, added to _total once on
+    ///        destruction.
+    class local_count {
+      public:
+        local_count(std::atomic<uint64_t>& _total): m_total(_total) {}
+
+        ~local_count() {
+          if(m_count != 0)
+            m_total.fetch_add(m_count, std::memory_order_relaxed);
+        }
+
+        void add(uint64_t _n) { m_count += _n; }
+
+      private:
+        std::atomic<uint64_t>& m_total;
+        uint64_t m_count{0};
+    };
+
+    /// @brief Cache and branch misses of the calling thread, read through
+    ///        perf_event_open. Does nothing where the events can not be
+    ///        opened, e.g. with a restrictive perf_event_paranoid.
+    class hardware_events {
+      public:
+        hardware_events() {
+          m_fds[0] = open_event(PERF_COUNT_HW_CACHE_MISSES);
+          m_fds[1] = open_event(PERF_COUNT_HW_BRANCH_MISSES);
+        }
+
+        ~hardware_events() {
+#ifdef __linux__
+          for(int fd : m_fds)
+            if(fd >= 0)
+              close(fd);
+#endif
+        }
+
+        /// @brief Adds the events since construction to _stats
+        void read_into(algorithm_stats& _stats) {
+          _stats.cache_misses.fetch_add(read_event(m_fds[0]),
+                                        std::memory_order_relaxed);
+          _stats.branch_misses.fetch_add(read_event(m_fds[1]),
+                                         std::memory_order_relaxed);
+        }
+
+      private:
+#ifdef __linux__
+        static int open_event(uint64_t _config) {
+          perf_event_attr attr;
+          memset(&attr, 0, sizeof(attr));
+          attr.size = sizeof(attr);
+          attr.type = PERF_TYPE_HARDWARE;
+          attr.config = _config;
+          attr.exclude_kernel = 1;
+          attr.exclude_hv = 1;
+          int fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+          if(fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+          }
+          return fd;
+        }
+
+        static uint64_t read_event(int _fd) {
+          uint64_t value = 0;
+          if(_fd < 0 || ::read(_fd, &value, sizeof(value)) != sizeof(value))
+            return 0;
+          return value;
+        }
+#else
+        static int open_event(uint64_t) { return -1; }
+        static uint64_t read_event(int) { return 0; }
+#endif
+
+        int m_fds[2];
+    };
+
+    /// @brief Times one algorithm run and reads the hardware events around
+    ///        it when they are turned on.
+    class algorithm_run {
+      public:
+        algorithm_run(Algorithm _algo): m_stats(stats().algo(_algo)),
+                                        m_start(now_ns()) {
+          m_stats.runs.fetch_add(1, std::memory_order_relaxed);
+          if(stats().hardware_counters)
+            m_events.emplace();
+        }
+
+        ~algorithm_run() {
+          if(m_events)
+            m_events->read_into(m_stats);
+          m_stats.total_ns.fetch_add(now_ns() - m_start,
+                                     std::memory_order_relaxed);
+        }
+
+        algorithm_stats& get() { return m_stats; }
+
+      private:
+        algorithm_stats& m_stats;
+        std::optional<hardware_events> m_events;
+        uint64_t m_start;
+    };
+  }
+}
+
+#define NOSTD_CONCAT_IMPL(a, b) a##b
+#define NOSTD_CONCAT(a, b) NOSTD_CONCAT_IMPL(a, b)
+
+/// @brief Times the rest of the scope as one call of operation _op.
+#define NOSTD_TIME_OP(_op) \
+  nostd::instrument::operation_timer NOSTD_CONCAT(nostd_op_timer_, __LINE__)( \
+      nostd::instrument::_op)
+
+/// @brief Starts recording one run of algorithm _algo for the rest of the
+///        scope; the other NOSTD_ALGO macros refer to it.
+#define NOSTD_ALGO_RUN(_algo) \
+  nostd::instrument::algorithm_run nostd_algo_run(nostd::instrument::_algo)
+
+#define NOSTD_ALGO_VERTICES(_n) \
+  nostd_algo_run.get().vertices_visited.fetch_add((_n), std::memory_order_relaxed)
+
+#define NOSTD_ALGO_EDGES(_n) \
+  nostd_algo_run.get().edges_traversed.fetch_add((_n), std::memory_order_relaxed)
+
+#define NOSTD_ALGO_FRONTIER(_n) nostd_algo_run.get().frontier.add(_n)
+
+/// @brief Starts an edge count private to the rest of the scope; for the
+///        body of a parallel loop
+#define NOSTD_ALGO_LOCAL_EDGES() \
+  nostd::instrument::local_count nostd_local_edges( \
+      nostd_algo_run.get().edges_traversed)
+
+#define NOSTD_ALGO_ADD_EDGES(_n) nostd_local_edges.add(_n)
+
+#else
+
+#define NOSTD_TIME_OP(_op)
+#define NOSTD_ALGO_RUN(_algo)
+#define NOSTD_ALGO_VERTICES(_n)
+#define NOSTD_ALGO_EDGES(_n)
+#define NOSTD_ALGO_FRONTIER(_n)
+#define NOSTD_ALGO_LOCAL_EDGES()
+#define NOSTD_ALGO_ADD_EDGES(_n)
+
+#endif // NOSTD_INSTRUMENT
+
+#endif // INSTRUMENT_H
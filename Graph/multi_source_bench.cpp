@@ -0,0 +1,63 @@
+#include "graph.h"
+#include "csr_graph.h"
+#include "multi_source_bfs.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Distances from a batch of sources over a random graph: one breadth first
+// search per source against bit parallel searches 64 and 256 wide.
+// usage: multi_source_bench [vertices] [degree] [sources]
+
+typedef nostd::graph<int, int> graph_type;
+typedef nostd::csr_graph<graph_type> csr_type;
+
+template<typename Func>
+double time_ms(Func _func) {
+  auto start = std::chrono::steady_clock::now();
+  _func();
+  auto stop = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+int main(int argc, char** argv) {
+  size_t n = (argc > 1) ? atoi(argv[1]) : 100000;
+  size_t d = (argc > 2) ? atoi(argv[2]) : 8;
+  size_t k = (argc > 3) ? atoi(argv[3]) : 512;
+
+  std::mt19937 rng(42);
+  graph_type g;
+  std::vector<graph_type::vertex*> verts;
+  for(size_t i = 0; i < n; ++i)
+    verts.push_back(g.insert_vertex(int(i)));
+  for(size_t i = 0; i < n; ++i)
+    for(size_t j = 0; j < d / 2; ++j)
+      g.insert_undirected(verts[i], verts[rng() % n], 1);
+  csr_type c(g);
+
+  std::vector<uint32_t> sources;
+  for(size_t i = 0; i < k; ++i)
+    sources.push_back(uint32_t(rng() % n));
+
+  std::vector<uint32_t> single;
+  double single_ms = time_ms([&] {
+    std::vector<uint32_t> dist;
+    for(auto s : sources) {
+      nostd::breath_first_search(c, s, dist);
+      single.insert(single.end(), dist.begin(), dist.end());
+    }
+  });
+
+  std::vector<uint32_t> narrow, wide;
+  double narrow_ms = time_ms([&] { nostd::multi_source_bfs<64>(c, sources, narrow); });
+  double wide_ms = time_ms([&] { nostd::multi_source_bfs<256>(c, sources, wide); });
+
+  std::cout << "vertices " << c.num_vertices() << " edges " << c.num_edges()
+            << " sources " << k << "\n"
+            << "single     " << single_ms << " ms\n"
+            << "ms_bfs 64  " << narrow_ms << " ms\n"
+            << "ms_bfs 256 " << wide_ms << " ms\n";
+  return (single == narrow && single == wide) ? 0 : 1;
+}
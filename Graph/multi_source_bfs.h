@@ -0,0 +1,213 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @name Multi Source BFS
+/// @group Graph Algorithms
+///
+/// @note Bit parallel breadth first search from many sources at once over a
+///       csr_graph (MS-BFS). Every vertex keeps a set of sources, one bit
+///       per concurrent search, for the searches that have seen it and for
+///       those whose frontier holds it. One scan of a neighbor list then
+///       advances every search that has the vertex on its frontier.
+///
+///       Width is the number of concurrent searches, a multiple of 64.
+///       A 256 wide set is processed with AVX2 when it is enabled (-mavx2),
+///       otherwise as four 64 bit words. Batches with more sources than
+///       Width are run as consecutive tiles of Width sources that reuse the
+///       same buffers.
+///
+///       Memory is 3 * Width / 8 bytes per vertex.
+///
+///////////////////////////////////////////////////////////////////////////////
+#ifndef MULTI_SOURCE_BFS_H
+#define MULTI_SOURCE_BFS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "csr_graph.h"
+
+namespace nostd {
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief Set of Words * 64 concurrent searches.
+  /////////////////////////////////////////////////////////////////////////////
+  template<size_t Words>
+  struct alignas(Words % 4 == 0 ? 32 : 8) source_set {
+    uint64_t bits[Words];
+
+    void clear() {
+      for(size_t i = 0; i < Words; ++i)
+        bits[i] = 0;
+    }
+
+    void set(size_t _bit) { bits[_bit / 64] |= uint64_t(1) << (_bit % 64); }
+
+    bool any() const {
+#ifdef __AVX2__
+      if constexpr(Words == 4) {
+        __m256i a = _mm256_load_si256((const __m256i*)bits);
+        return !_mm256_testz_si256(a, a);
+      }
+#endif
+      uint64_t x = 0;
+      for(size_t i = 0; i < Words; ++i)
+        x |= bits[i];
+      return x != 0;
+    }
+
+    /// @return Whether some search in this set is not in _other
+    bool any_not_in(const source_set& _other) const {
+#ifdef __AVX2__
+      if constexpr(Words == 4) {
+        __m256i a = _mm256_load_si256((const __m256i*)bits);
+        __m256i b = _mm256_load_si256((const __m256i*)_other.bits);
+        return !_mm256_testc_si256(b, a);
+      }
+#endif
+      uint64_t x = 0;
+      for(size_t i = 0; i < Words; ++i)
+        x |= bits[i] & ~_other.bits[i];
+      return x != 0;
+    }
+
+    void merge(const source_set& _other) {
+#ifdef __AVX2__
+      if constexpr(Words == 4) {
+        __m256i a = _mm256_load_si256((const __m256i*)bits);
+        __m256i b = _mm256_load_si256((const __m256i*)_other.bits);
+        _mm256_store_si256((__m256i*)bits, _mm256_or_si256(a, b));
+        return;
+      }
+#endif
+      for(size_t i = 0; i < Words; ++i)
+        bits[i] |= _other.bits[i];
+    }
+
+    /// @brief merge that is safe against concurrent merges into this set
+    void atomic_merge(const source_set& _other) {
+      for(size_t i = 0; i < Words; ++i)
+        if(_other.bits[i] & ~__atomic_load_n(&bits[i], __ATOMIC_RELAXED))
+          __atomic_fetch_or(&bits[i], _other.bits[i], __ATOMIC_RELAXED);
+    }
+
+    void remove(const source_set& _other) {
+#ifdef __AVX2__
+      if constexpr(Words == 4) {
+        __m256i a = _mm256_load_si256((const __m256i*)bits);
+        __m256i b = _mm256_load_si256((const __m256i*)_other.bits);
+        _mm256_store_si256((__m256i*)bits, _mm256_andnot_si256(b, a));
+        return;
+      }
+#endif
+      for(size_t i = 0; i < Words; ++i)
+        bits[i] &= ~_other.bits[i];
+    }
+
+    /// @brief Calls _func(bit) for every search in the set
+    template<typename Func>
+    void for_each(Func _func) const {
+      for(size_t i = 0; i < Words; ++i)
+        for(uint64_t x = bits[i]; x != 0; x &= x - 1)
+          _func(i * 64 + __builtin_ctzll(x));
+    }
+  };
+
+  /// @brief Breadth first search from every vertex in _sources.
+  /// @param _discover Called as _discover(k, v, level) when the search from
+  ///        _sources[k] reaches vertex id v at level hops, including
+  ///        (k, _sources[k], 0). With an executor it is called concurrently,
+  ///        but never twice for the same (k, v).
+  template<size_t Width = 64, typename GraphType, typename Func>
+  void multi_source_bfs(const csr_graph<GraphType>& _graph,
+                        const std::vector<typename csr_graph<GraphType>::vertex_id>& _sources,
+                        Func _discover,
+                        executor* _exec = nullptr) {
+    static_assert(Width % 64 == 0, "Width must be a multiple of 64");
+    typedef typename csr_graph<GraphType>::vertex_id vertex_id;
+    typedef source_set<Width / 64> set_type;
+    NOSTD_ALGO_RUN(MS_BFS);
+
+    size_t n = _graph.num_vertices();
+    const size_t grain = 1024;
+
+    std::vector<set_type> seen(n), visit(n), next(n);
+
+    for(size_t tile = 0; tile < _sources.size(); tile += Width) {
+      size_t count = std::min(Width, _sources.size() - tile);
+
+      parallel_for(_exec, 0, n, [&](size_t v) {
+        seen[v].clear();
+        visit[v].clear();
+        next[v].clear();
+      }, grain * 16);
+
+      for(size_t k = 0; k < count; ++k) {
+        vertex_id s = _sources[tile + k];
+        seen[s].set(k);
+        visit[s].set(k);
+        _discover(tile + k, s, 0);
+      }
+
+      bool active = count > 0;
+      for(uint32_t level = 1; active; ++level) {
+        // every vertex on some frontier pushes its searches to the
+        // neighbors that have not been seen by all of them
+        parallel_for(_exec, 0, n, [&](size_t v) {
+          if(!visit[v].any())
+            return;
+          NOSTD_ALGO_VERTICES(1);
+          NOSTD_ALGO_EDGES(_graph.out_degree(vertex_id(v)));
+          for(vertex_id w : _graph.neighbors(vertex_id(v))) {
+            if(!visit[v].any_not_in(seen[w]))
+              continue;
+            if(_exec == nullptr)
+              next[w].merge(visit[v]);
+            else
+              next[w].atomic_merge(visit[v]);
+          }
+        }, grain, DYNAMIC);
+
+        // keep the searches reaching a vertex for the first time
+        std::atomic<bool> found(false);
+        parallel_for(_exec, 0, n, [&](size_t v) {
+          next[v].remove(seen[v]);
+          visit[v] = next[v];
+          next[v].clear();
+          if(!visit[v].any())
+            return;
+          seen[v].merge(visit[v]);
+          visit[v].for_each([&](size_t _k) {
+            _discover(tile + _k, vertex_id(v), level);
+          });
+          found.store(true, std::memory_order_relaxed);
+        }, grain, DYNAMIC);
+        active = found.load();
+      }
+    }
+  }
+
+  /// @brief Distances from every vertex in _sources.
+  /// @param _dist Set to a row of num_vertices() entries per source:
+  ///        _dist[k * num_vertices() + v] is the number of hops from
+  ///        _sources[k] to v, or INVALID_ID for unreachable vertices.
+  template<size_t Width = 64, typename GraphType>
+  void multi_source_bfs(const csr_graph<GraphType>& _graph,
+                        const std::vector<typename csr_graph<GraphType>::vertex_id>& _sources,
+                        std::vector<uint32_t>& _dist,
+                        executor* _exec = nullptr) {
+    size_t n = _graph.num_vertices();
+    _dist.assign(n * _sources.size(), csr_graph<GraphType>::INVALID_ID);
+    uint32_t* dist = _dist.data();
+    multi_source_bfs<Width>(_graph, _sources,
+        [dist, n](size_t _k, uint32_t _v, uint32_t _level) {
+          dist[_k * n + _v] = _level;
+        }, _exec);
+  }
+}
+
+#endif // MULTI_SOURCE_BFS_H
@@ -0,0 +1,103 @@
+#include "graph.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Counts how many times heavy vertex and edge properties are copied while
+// building, searching, copying and moving a graph.
+// usage: property_bench [vertices] [edges per vertex]
+
+// a string and a small vector, like the properties stored in practice
+struct heavy {
+  static size_t copies;
+
+  heavy() {}
+  heavy(const std::string& _name, size_t _n): name(_name), weights(_n, 1.0) {}
+  heavy(const heavy& _other): name(_other.name), weights(_other.weights) { ++copies; }
+  heavy(heavy&&) noexcept = default;
+  heavy& operator=(const heavy& _other) {
+    name = _other.name;
+    weights = _other.weights;
+    ++copies;
+    return *this;
+  }
+  heavy& operator=(heavy&&) noexcept = default;
+
+  std::string name;
+  std::vector<double> weights;
+};
+
+size_t heavy::copies = 0;
+
+typedef nostd::graph<heavy, heavy> graph_type;
+
+template<typename Func>
+void measure(const char* _name, Func _func) {
+  heavy::copies = 0;
+  auto start = std::chrono::steady_clock::now();
+  _func();
+  auto stop = std::chrono::steady_clock::now();
+  std::cout << _name << ": copies " << heavy::copies << " ms "
+            << std::chrono::duration<double, std::milli>(stop - start).count()
+            << "\n";
+}
+
+int main(int argc, char** argv) {
+  size_t n = (argc > 1) ? atoi(argv[1]) : 20000;
+  size_t d = (argc > 2) ? atoi(argv[2]) : 4;
+  const std::string name = "a property name too long for the small string buffer";
+
+  graph_type by_ref, by_move, by_emplace;
+  std::vector<graph_type::vertex*> ref_verts, move_verts, emplace_verts;
+
+  measure("insert const&", [&] {
+    for(size_t i = 0; i < n; ++i) {
+      heavy prop(name, 4);
+      ref_verts.push_back(by_ref.insert_vertex(prop));
+    }
+    for(size_t i = 0; i < n; ++i)
+      for(size_t k = 1; k <= d; ++k) {
+        heavy prop(name, 2);
+        by_ref.insert_edge(ref_verts[i], ref_verts[(i * 31 + k) % n], prop);
+      }
+  });
+
+  measure("insert &&", [&] {
+    for(size_t i = 0; i < n; ++i)
+      move_verts.push_back(by_move.insert_vertex(heavy(name, 4)));
+    for(size_t i = 0; i < n; ++i)
+      for(size_t k = 1; k <= d; ++k)
+        by_move.insert_edge(move_verts[i], move_verts[(i * 31 + k) % n],
+                            heavy(name, 2));
+  });
+
+  measure("emplace", [&] {
+    for(size_t i = 0; i < n; ++i)
+      emplace_verts.push_back(by_emplace.emplace_vertex(name, 4));
+    for(size_t i = 0; i < n; ++i)
+      for(size_t k = 1; k <= d; ++k)
+        by_emplace.emplace_edge(emplace_verts[i],
+                                emplace_verts[(i * 31 + k) % n], name, 2);
+  });
+
+  size_t found = 0;
+  measure("find_edge", [&] {
+    for(size_t i = 0; i < n; ++i)
+      for(size_t k = 1; k <= d; ++k)
+        if(by_emplace.find_edge(emplace_verts[i],
+                                emplace_verts[(i * 31 + k) % n]) != by_emplace.edge_end())
+          ++found;
+  });
+
+  graph_type copy;
+  measure("copy", [&] { copy = by_emplace; });
+
+  graph_type moved;
+  measure("move", [&] { moved = std::move(by_emplace); });
+
+  std::cout << "vertices " << copy.num_vertices() << " edges "
+            << copy.num_edges() << " found " << found << "\n";
+  return 0;
+}
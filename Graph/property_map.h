@@ -0,0 +1,179 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @name Property Maps
+/// @group Graph Algorithms
+///
+/// @note Dense external property maps. Values live in a vector indexed by
+///       the dense index of a vertex or edge, so an access is one load and
+///       a map can be reused across algorithm runs: reset only allocates
+///       when the graph grew past the map's capacity.
+///
+///       property_arrays keeps several per vertex fields of an algorithm as
+///       a struct of arrays, one property map per field.
+///
+///       Avoid bool values, std::vector<bool> packs them into bits which
+///       can not be written from several threads.
+///
+///////////////////////////////////////////////////////////////////////////////
+#ifndef PROPERTY_MAP_H
+#define PROPERTY_MAP_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+namespace nostd {
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief Property map over any key with an index() member.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename T>
+  class index_property_map {
+    public:
+      typedef T value_type;
+
+      /// @name constructors
+      /// @{
+      index_property_map(size_t _size = 0, const T& _value = T()):
+                         m_values(_size, _value) {}
+      /// @}
+
+      /// @name Element Access
+      /// @{
+      template<typename Key>
+      T& operator[](const Key* _key) { return m_values[_key->index()]; }
+
+      template<typename Key>
+      const T& operator[](const Key* _key) const { return m_values[_key->index()]; }
+
+      T& operator[](size_t _index) { return m_values[_index]; }
+      const T& operator[](size_t _index) const { return m_values[_index]; }
+
+      T* data() { return m_values.data(); }
+      const T* data() const { return m_values.data(); }
+
+      size_t size() const { return m_values.size(); }
+      /// @}
+
+      /// @name Manipulation
+      /// @{
+
+      /// @brief Sets _size values to _value, keeping the capacity.
+      void reset(size_t _size, const T& _value = T()) {
+        m_values.assign(_size, _value);
+      }
+
+      /// @brief Adds the value of a newly inserted vertex or edge
+      void push_back(const T& _value) { m_values.push_back(_value); }
+
+      /// @brief Follows the graph erasing the vertex or edge at _index: the
+      ///        last value moves into its place.
+      void swap_remove(size_t _index) {
+        m_values[_index] = m_values.back();
+        m_values.pop_back();
+      }
+      /// @}
+
+    protected:
+      std::vector<T> m_values;
+  };
+
+  /// @brief Property map keyed by the vertices of a graph.
+  template<typename T>
+  class vertex_property_map : public index_property_map<T> {
+    public:
+      vertex_property_map() {}
+
+      template<typename GraphType>
+      vertex_property_map(const GraphType& _graph, const T& _value = T()):
+          index_property_map<T>(_graph.num_vertices(), _value) {}
+
+      template<typename GraphType>
+      void reset(const GraphType& _graph, const T& _value = T()) {
+        index_property_map<T>::reset(_graph.num_vertices(), _value);
+      }
+  };
+
+  /// @brief Property map keyed by the edges of a graph.
+  template<typename T>
+  class edge_property_map : public index_property_map<T> {
+    public:
+      edge_property_map() {}
+
+      template<typename GraphType>
+      edge_property_map(const GraphType& _graph, const T& _value = T()):
+          index_property_map<T>(_graph.num_edges(), _value) {}
+
+      template<typename GraphType>
+      void reset(const GraphType& _graph, const T& _value = T()) {
+        index_property_map<T>::reset(_graph.num_edges(), _value);
+      }
+  };
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief Struct of arrays; one vertex property map per field.
+  ///        get<I>() is the map holding the I'th field.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename... Fields>
+  class property_arrays {
+    public:
+      template<size_t I>
+      vertex_property_map<typename std::tuple_element<I, std::tuple<Fields...>>::type>&
+      get() { return std::get<I>(m_maps); }
+
+      template<size_t I>
+      const vertex_property_map<typename std::tuple_element<I, std::tuple<Fields...>>::type>&
+      get() const { return std::get<I>(m_maps); }
+
+      /// @brief Value initializes every field of every vertex.
+      template<typename GraphType>
+      void reset(const GraphType& _graph) {
+        std::apply([&](auto&... _map) { (_map.reset(_graph), ...); }, m_maps);
+      }
+
+    private:
+      std::tuple<vertex_property_map<Fields>...> m_maps;
+  };
+
+  /// @brief Weight functor reading the property of an edge; the default
+  ///        weight of the weighted algorithms
+  struct edge_weight {
+    template<typename Edge>
+    auto operator()(const Edge* _edge) const { return _edge->property(); }
+  };
+
+  /// @brief Weight functor counting hops
+  struct unit_weight {
+    template<typename Edge>
+    uint32_t operator()(const Edge*) const { return 1; }
+  };
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief Copyable atomic, so atomics can be stored in property maps.
+  ///        Copies are not atomic with respect to each other.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename T>
+  class atomic_cell {
+    public:
+      atomic_cell(T _value = T()): m_value(_value) {}
+      atomic_cell(const atomic_cell& _other): m_value(_other.load()) {}
+
+      atomic_cell& operator=(const atomic_cell& _other) {
+        store(_other.load());
+        return *this;
+      }
+
+      T load() const { return m_value.load(std::memory_order_relaxed); }
+      void store(T _value) { m_value.store(_value, std::memory_order_relaxed); }
+
+      bool compare_exchange(T& _expected, T _desired) {
+        return m_value.compare_exchange_strong(_expected, _desired);
+      }
+
+    private:
+      std::atomic<T> m_value;
+  };
+}
+
+#endif // PROPERTY_MAP_H
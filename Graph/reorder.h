@@ -0,0 +1,150 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @name Graph Reordering
+/// @group Graph Algorithms
+///
+/// @note Relabels the dense vertex indices of a graph so that vertices which
+///       are accessed together get nearby indices. Anything laid out by
+///       index afterwards, like a csr_graph snapshot, inherits the locality.
+///
+///       DEGREE_ORDER - highest degree first
+///       RCM_ORDER    - reverse Cuthill-McKee, small bandwidth
+///       BFS_ORDER    - breadth first discovery order
+///       HUB_ORDER    - hub clustering; vertices above the average degree
+///                      are packed first, keeping their relative order
+///
+///       Edge direction is ignored when computing an ordering. Descriptors
+///       of a DESCRIPTOR_GRAPH are not changed, only the indices.
+///
+///       DEGREE_ORDER and HUB_ORDER only pay off when degrees are skewed:
+///       they pack the few vertices touched by most edges together. When
+///       every degree is about the same they just shuffle the graph. BFS
+///       over a csr snapshot of a 250000 vertex graph with random indices
+///       (reorder_bench) ran:
+///
+///                       degree      rcm        bfs        hub
+///           grid        0.98-1.3x   3.9x       3.7-4.0x   0.9-1.3x
+///           skewed      0.86-1.6x   0.85-1.4x  3.0-3.4x   1.1-1.4x
+///
+///       so BFS_ORDER, or RCM_ORDER on mesh-like graphs, is the default
+///       choice; HUB_ORDER is the cheaper one for skewed graphs, since it
+///       needs no search and keeps the relative order of the rest.
+///
+///////////////////////////////////////////////////////////////////////////////
+#ifndef REORDER_H
+#define REORDER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace nostd {
+
+  enum Ordering { DEGREE_ORDER, RCM_ORDER, BFS_ORDER, HUB_ORDER };
+
+  /// @return The inverse of _perm, mapping new indices back to old ones.
+  inline std::vector<size_t> invert_permutation(const std::vector<size_t>& _perm) {
+    std::vector<size_t> inverse(_perm.size());
+    for(size_t i = 0; i < _perm.size(); ++i)
+      inverse[_perm[i]] = i;
+    return inverse;
+  }
+
+  /// @brief Computes an ordering of the vertices without changing the
+  ///        graph. _graph may be a view from graph_view.h; vertices outside
+  ///        the view are ordered as if isolated.
+  /// @return The vertex indices in their new order; entry k is the old index
+  ///         of the vertex that gets index k.
+  template<typename GraphType>
+  std::vector<size_t> compute_order(const GraphType& _graph, Ordering _strategy) {
+    size_t n = _graph.num_vertices();
+    std::vector<size_t> order;
+    order.reserve(n);
+
+    // vertices outside a view have no degree and no neighbors
+    std::vector<size_t> degree(n, 0);
+    for(size_t i = 0; i < n; ++i) {
+      auto v = _graph.vertex_at(i);
+      if(_graph.contains(v))
+        degree[i] = _graph.out_degree(v) + _graph.in_degree(v);
+    }
+
+    if(_strategy == DEGREE_ORDER) {
+      for(size_t i = 0; i < n; ++i)
+        order.push_back(i);
+      std::stable_sort(order.begin(), order.end(), [&](size_t _a, size_t _b) {
+        return degree[_a] > degree[_b];
+      });
+      return order;
+    }
+
+    if(_strategy == HUB_ORDER) {
+      size_t total = 0;
+      for(auto d : degree)
+        total += d;
+      for(size_t i = 0; i < n; ++i)
+        if(degree[i] * n > total)
+          order.push_back(i);
+      for(size_t i = 0; i < n; ++i)
+        if(degree[i] * n <= total)
+          order.push_back(i);
+      return order;
+    }
+
+    // BFS_ORDER and RCM_ORDER, one search per component
+    std::vector<size_t> starts;
+    for(size_t i = 0; i < n; ++i)
+      starts.push_back(i);
+    if(_strategy == RCM_ORDER)
+      // low degree vertices sit on the periphery, start from them
+      std::stable_sort(starts.begin(), starts.end(), [&](size_t _a, size_t _b) {
+        return degree[_a] < degree[_b];
+      });
+
+    std::vector<bool> visited(n, false);
+    std::vector<size_t> adj;
+    for(auto s : starts) {
+      if(visited[s])
+        continue;
+      visited[s] = true;
+      size_t head = order.size();
+      order.push_back(s);
+
+      for(; head < order.size(); ++head) {
+        auto v = _graph.vertex_at(order[head]);
+        adj.clear();
+        if(_graph.contains(v)) {
+          for(auto e = _graph.out_begin(v); e != _graph.out_end(v); ++e)
+            adj.push_back(_graph.target(*e)->index());
+          for(auto e = _graph.in_begin(v); e != _graph.in_end(v); ++e)
+            adj.push_back(_graph.source(*e)->index());
+        }
+
+        if(_strategy == RCM_ORDER)
+          std::stable_sort(adj.begin(), adj.end(), [&](size_t _a, size_t _b) {
+            return degree[_a] < degree[_b];
+          });
+        for(auto u : adj)
+          if(!visited[u]) {
+            visited[u] = true;
+            order.push_back(u);
+          }
+      }
+    }
+
+    if(_strategy == RCM_ORDER)
+      std::reverse(order.begin(), order.end());
+    return order;
+  }
+
+  /// @brief Relabels the vertices of _graph using _strategy.
+  /// @return The permutation applied; the vertex that had index i now has
+  ///         index perm[i]. invert_permutation maps back.
+  template<typename GraphType>
+  std::vector<size_t> reorder(GraphType& _graph, Ordering _strategy) {
+    std::vector<size_t> perm = invert_permutation(compute_order(_graph, _strategy));
+    _graph.relabel(perm);
+    return perm;
+  }
+}
+
+#endif // REORDER_H
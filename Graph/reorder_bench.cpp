@@ -0,0 +1,103 @@
+#include "graph.h"
+#include "csr_graph.h"
+#include "reorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Times breadth first search over a csr snapshot of two graphs whose
+// vertices are inserted in random order, before and after reordering: a
+// grid, where every degree is about the same, and a preferential
+// attachment graph, whose degrees are skewed.
+// usage: reorder_bench [side] [runs]
+
+typedef nostd::graph<int, int> graph_type;
+
+double bfs_time(const graph_type& _g, size_t _runs) {
+  nostd::csr_graph<graph_type> c(_g);
+  std::vector<uint32_t> dist;
+  std::vector<double> times;
+  for(size_t r = 0; r < _runs; ++r) {
+    auto start = std::chrono::steady_clock::now();
+    nostd::breath_first_search(c, 0, dist);
+    auto stop = std::chrono::steady_clock::now();
+    times.push_back(std::chrono::duration<double, std::milli>(stop - start).count());
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+// vertex c of the graph is verts[c]; they are inserted in random order
+std::vector<graph_type::vertex*> shuffled_vertices(graph_type& _g, size_t _n) {
+  std::vector<size_t> cells(_n);
+  for(size_t i = 0; i < _n; ++i)
+    cells[i] = i;
+  std::shuffle(cells.begin(), cells.end(), std::mt19937(42));
+  std::vector<graph_type::vertex*> verts(_n);
+  for(auto c : cells)
+    verts[c] = _g.insert_vertex(int(c));
+  return verts;
+}
+
+void build_grid(graph_type& _g, size_t _side) {
+  auto verts = shuffled_vertices(_g, _side * _side);
+  for(size_t y = 0; y < _side; ++y)
+    for(size_t x = 0; x < _side; ++x) {
+      size_t c = y * _side + x;
+      if(x + 1 < _side)
+        _g.insert_undirected(verts[c], verts[c + 1], 1);
+      if(y + 1 < _side)
+        _g.insert_undirected(verts[c], verts[c + _side], 1);
+    }
+}
+
+// every new vertex links to 4 earlier ones picked proportional to degree
+void build_skewed(graph_type& _g, size_t _n) {
+  auto verts = shuffled_vertices(_g, _n);
+  std::mt19937 rng(7);
+  std::vector<size_t> ends = {0};
+  for(size_t v = 1; v < _n; ++v) {
+    for(size_t k = 0; k < 4; ++k) {
+      size_t u = ends[rng() % ends.size()];
+      _g.insert_undirected(verts[v], verts[u], 1);
+      ends.push_back(u);
+      ends.push_back(v);
+    }
+  }
+}
+
+void run(const char* _name, graph_type& _g, size_t _runs) {
+  double base = bfs_time(_g, _runs);
+  std::cout << _name << ": vertices " << _g.num_vertices() << " edges "
+            << _g.num_edges() << "\n" << "random  " << base << " ms\n";
+
+  const char* names[] = {"degree", "rcm", "bfs", "hub"};
+  nostd::Ordering orders[] = {nostd::DEGREE_ORDER, nostd::RCM_ORDER,
+                              nostd::BFS_ORDER, nostd::HUB_ORDER};
+  for(size_t i = 0; i < 4; ++i) {
+    auto perm = nostd::reorder(_g, orders[i]);
+    double t = bfs_time(_g, _runs);
+    std::cout << names[i] << "\t" << t << " ms  speedup " << base / t << "\n";
+    _g.relabel(nostd::invert_permutation(perm));
+  }
+}
+
+int main(int argc, char** argv) {
+  size_t side = (argc > 1) ? atoi(argv[1]) : 500;
+  size_t runs = (argc > 2) ? atoi(argv[2]) : 5;
+
+  {
+    graph_type g;
+    build_grid(g, side);
+    run("grid", g, runs);
+  }
+  {
+    graph_type g;
+    build_skewed(g, side * side);
+    run("skewed", g, runs);
+  }
+  return 0;
+}
@@ -0,0 +1,436 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @name Shortest Paths
+/// @group Graph Algorithms
+///
+/// @note Point to point shortest paths over non negative edge weights.
+///
+///       dijkstra_search               - stops once the target is settled
+///       bidirectional_dijkstra_search - searches forward from the source
+///                                       over out edges and backward from
+///                                       the target over in edges
+///       astar_search                  - Dijkstra guided by a lower bound
+///                                       on the distance to the target
+///       landmarks                     - ALT preprocessing; its heuristic
+///                                       makes A* goal directed on any
+///                                       graph
+///
+///       The weight of an edge is given by a functor called with the edge,
+///       by default the edge property. Search state lives in a
+///       path_workspace. Its labels are stamped with the query they belong
+///       to, so reusing a workspace makes a query cost proportional to the
+///       vertices it touches rather than the size of the graph.
+///
+///////////////////////////////////////////////////////////////////////////////
+#ifndef SHORTEST_PATH_H
+#define SHORTEST_PATH_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "instrument.h"
+#include "property_map.h"
+
+namespace nostd {
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief Labels and queue of one search direction.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename GraphType, typename Weight>
+  class search_direction {
+    public:
+      typedef typename GraphType::vertex vertex;
+      typedef typename GraphType::edge edge;
+
+      static Weight infinity() { return std::numeric_limits<Weight>::max(); }
+
+      /// @brief Forgets the previous search and queues _root at distance 0
+      void start(const GraphType& _graph, vertex* _root) {
+        if(m_stamp.size() != _graph.num_vertices() ||
+           m_current == std::numeric_limits<uint32_t>::max()) {
+          m_stamp.reset(_graph, 0);
+          m_dist.reset(_graph);
+          m_pred.reset(_graph, nullptr);
+          m_current = 0;
+        }
+        ++m_current;
+        m_heap.clear();
+        relax(_root, Weight(0), nullptr, Weight(0));
+      }
+
+      bool reached(const vertex* _vert) const { return m_stamp[_vert] == m_current; }
+
+      Weight distance(const vertex* _vert) const {
+        return reached(_vert) ? m_dist[_vert] : infinity();
+      }
+
+      /// @return Vertex before _vert on the best known path, nullptr for
+      ///         the root and unreached vertices.
+      vertex* predecessor(const vertex* _vert) const {
+        return reached(_vert) ? m_pred[_vert] : nullptr;
+      }
+
+      /// @brief Queues _vert with key _key if _dist improves on its label
+      bool relax(vertex* _vert, Weight _dist, vertex* _pred, Weight _key) {
+        if(reached(_vert) && m_dist[_vert] <= _dist)
+          return false;
+        m_stamp[_vert] = m_current;
+        m_dist[_vert] = _dist;
+        m_pred[_vert] = _pred;
+        m_heap.push_back(entry{_key, _dist, _vert});
+        std::push_heap(m_heap.begin(), m_heap.end(), later);
+        return true;
+      }
+
+      /// @return Smallest key in the queue, infinity() when it is empty
+      Weight min_key() {
+        drop_stale();
+        return m_heap.empty() ? infinity() : m_heap.front().key;
+      }
+
+      /// @return Vertex with the smallest key, nullptr when the queue is empty
+      vertex* pop() {
+        drop_stale();
+        if(m_heap.empty())
+          return nullptr;
+        vertex* vert = m_heap.front().vert;
+        std::pop_heap(m_heap.begin(), m_heap.end(), later);
+        m_heap.pop_back();
+        return vert;
+      }
+
+    private:
+      struct entry {
+        Weight key;
+        Weight dist;
+        vertex* vert;
+      };
+
+      static bool later(const entry& _a, const entry& _b) { return _a.key > _b.key; }
+
+      // entries left behind when a vertex was queued again at a shorter
+      // distance
+      void drop_stale() {
+        while(!m_heap.empty() && m_heap.front().dist != m_dist[m_heap.front().vert]) {
+          std::pop_heap(m_heap.begin(), m_heap.end(), later);
+          m_heap.pop_back();
+        }
+      }
+
+      vertex_property_map<uint32_t> m_stamp;    // query that set the label
+      vertex_property_map<Weight> m_dist;
+      vertex_property_map<vertex*> m_pred;
+      std::vector<entry> m_heap;
+      uint32_t m_current{0};
+  };
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief Reusable state of the point to point searches; after a query it
+  ///        holds the labels and the path that was found.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename GraphType, typename Weight = typename GraphType::edge_type>
+  struct path_workspace {
+    typedef typename GraphType::vertex vertex;
+
+    search_direction<GraphType, Weight> forward;
+    search_direction<GraphType, Weight> backward;
+    vertex* meet{nullptr};          // vertex joining the two halves of the path
+    bool bidirectional{false};      // whether the last query used backward
+    size_t settled{0};              // vertices the last query settled
+
+    /// @return Vertices of the last path found from source to target,
+    ///         empty when the target was unreachable.
+    std::vector<vertex*> path() const {
+      std::vector<vertex*> result;
+      if(meet == nullptr)
+        return result;
+      for(vertex* v = meet; v != nullptr; v = forward.predecessor(v))
+        result.push_back(v);
+      std::reverse(result.begin(), result.end());
+      if(bidirectional)
+        for(vertex* v = backward.predecessor(meet); v != nullptr;
+            v = backward.predecessor(v))
+          result.push_back(v);
+      return result;
+    }
+
+    void begin_query(bool _bidirectional) {
+      meet = nullptr;
+      bidirectional = _bidirectional;
+      settled = 0;
+    }
+  };
+
+  /// @brief Dijkstra's algorithm from _source, stopping once _target is
+  ///        settled. With a null _target every reachable vertex is settled.
+  /// @return Distance to _target, or the maximum Weight if unreachable
+  template<typename GraphType, typename Weight, typename WeightFunc = edge_weight>
+  Weight dijkstra_search(const GraphType& _graph,
+                         typename GraphType::vertex* _source,
+                         typename GraphType::vertex* _target,
+                         path_workspace<GraphType, Weight>& _work,
+                         WeightFunc _weight = WeightFunc()) {
+    NOSTD_ALGO_RUN(SHORTEST_PATH);
+    auto& forward = _work.forward;
+    _work.begin_query(false);
+    forward.start(_graph, _source);
+
+    while(auto v = forward.pop()) {
+      ++_work.settled;
+      if(v == _target) {
+        _work.meet = v;
+        break;
+      }
+      Weight dist = forward.distance(v);
+      for(auto iter = _graph.out_begin(v); iter != _graph.out_end(v); ++iter) {
+        Weight next = dist + Weight(_weight(*iter));
+        forward.relax(_graph.target(*iter), next, v, next);
+      }
+    }
+    NOSTD_ALGO_VERTICES(_work.settled);
+    return (_target == nullptr) ? Weight(0) : forward.distance(_target);
+  }
+
+  /// @brief Bidirectional Dijkstra. The backward search follows in edges
+  ///        from _target; the searches stop once the smallest keys of both
+  ///        queues add up to at least the best path seen.
+  /// @return Distance from _source to _target, or the maximum Weight
+  template<typename GraphType, typename Weight, typename WeightFunc = edge_weight>
+  Weight bidirectional_dijkstra_search(const GraphType& _graph,
+                                       typename GraphType::vertex* _source,
+                                       typename GraphType::vertex* _target,
+                                       path_workspace<GraphType, Weight>& _work,
+                                       WeightFunc _weight = WeightFunc()) {
+    NOSTD_ALGO_RUN(SHORTEST_PATH);
+    auto& forward = _work.forward;
+    auto& backward = _work.backward;
+    _work.begin_query(true);
+    forward.start(_graph, _source);
+    backward.start(_graph, _target);
+
+    Weight best = forward.infinity();
+    if(_source == _target) {
+      _work.meet = _source;
+      best = Weight(0);
+    }
+
+    auto meet = [&](typename GraphType::vertex* _vert) {
+      Weight dist = forward.distance(_vert) + backward.distance(_vert);
+      if(dist < best) {
+        best = dist;
+        _work.meet = _vert;
+      }
+    };
+
+    while(true) {
+      Weight front = forward.min_key();
+      Weight back = backward.min_key();
+      if(front == forward.infinity() || back == backward.infinity() ||
+         front + back >= best)
+        break;
+
+      ++_work.settled;
+      if(front <= back) {
+        auto v = forward.pop();
+        Weight dist = forward.distance(v);
+        for(auto iter = _graph.out_begin(v); iter != _graph.out_end(v); ++iter) {
+          auto target = _graph.target(*iter);
+          Weight next = dist + Weight(_weight(*iter));
+          if(forward.relax(target, next, v, next) && backward.reached(target))
+            meet(target);
+        }
+      }
+      else {
+        auto v = backward.pop();
+        Weight dist = backward.distance(v);
+        for(auto iter = _graph.in_begin(v); iter != _graph.in_end(v); ++iter) {
+          auto source = _graph.source(*iter);
+          Weight next = dist + Weight(_weight(*iter));
+          if(backward.relax(source, next, v, next) && forward.reached(source))
+            meet(source);
+        }
+      }
+    }
+    NOSTD_ALGO_VERTICES(_work.settled);
+    return best;
+  }
+
+  /// @brief A* search. _heuristic(v) must be a lower bound on the distance
+  ///        from v to _target; vertices are reopened when a shorter path
+  ///        turns up, so the bound does not have to be consistent.
+  /// @return Distance from _source to _target, or the maximum Weight
+  template<typename GraphType, typename Weight, typename Heuristic,
+           typename WeightFunc = edge_weight>
+  Weight astar_search(const GraphType& _graph,
+                      typename GraphType::vertex* _source,
+                      typename GraphType::vertex* _target,
+                      path_workspace<GraphType, Weight>& _work,
+                      Heuristic _heuristic,
+                      WeightFunc _weight = WeightFunc()) {
+    NOSTD_ALGO_RUN(SHORTEST_PATH);
+    auto& forward = _work.forward;
+    _work.begin_query(false);
+    forward.start(_graph, _source);
+
+    while(auto v = forward.pop()) {
+      ++_work.settled;
+      if(v == _target) {
+        _work.meet = v;
+        break;
+      }
+      Weight dist = forward.distance(v);
+      for(auto iter = _graph.out_begin(v); iter != _graph.out_end(v); ++iter) {
+        auto target = _graph.target(*iter);
+        Weight next = dist + Weight(_weight(*iter));
+        if(!forward.reached(target) || next < forward.distance(target)) {
+          Weight bound = Weight(_heuristic(target));
+          if(bound == forward.infinity())
+            continue;
+          forward.relax(target, next, v, next + bound);
+        }
+      }
+    }
+    NOSTD_ALGO_VERTICES(_work.settled);
+    return forward.distance(_target);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief ALT preprocessing: exact distances from and to a few landmark
+  ///        vertices, which bound the distance between any two vertices by
+  ///        the triangle inequality.
+  ///
+  ///        Landmarks are picked greedily, each the vertex farthest from the
+  ///        ones already chosen; the first is the vertex farthest from the
+  ///        lowest index. Asking for more landmarks than there are vertices
+  ///        gives one per vertex. The distances are kept in one vertex major
+  ///        array, so the bound for a vertex reads a single contiguous run
+  ///        of 2 * size() values. They are keyed by vertex index; rebuild
+  ///        after changing the graph.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename GraphType, typename Weight = typename GraphType::edge_type>
+  class landmarks {
+    public:
+      typedef typename GraphType::vertex vertex;
+
+      /// @brief Lower bound on the distance to one target, for astar_search
+      class heuristic {
+        public:
+          heuristic(const landmarks* _marks, const vertex* _target):
+                    m_marks(_marks), m_target(_target) {}
+
+          Weight operator()(const vertex* _vert) const {
+            return m_marks->lower_bound(_vert, m_target);
+          }
+
+        private:
+          const landmarks* m_marks;
+          const vertex* m_target;
+      };
+
+      /// @name constructors
+      /// @{
+      template<typename WeightFunc = edge_weight>
+      landmarks(const GraphType& _graph, size_t _count,
+                WeightFunc _weight = WeightFunc()) {
+        size_t n = _graph.num_vertices();
+        // vertices outside a view, and those already chosen, are never picked
+        std::vector<bool> eligible(n);
+        size_t available = 0;
+        for(size_t v = 0; v < n; ++v) {
+          eligible[v] = _graph.contains(_graph.vertex_at(v));
+          available += eligible[v];
+        }
+        _count = std::min(_count, available);
+        m_count = _count;
+        m_dist.assign(n * _count * 2, infinity());
+
+        path_workspace<GraphType, Weight> work;
+        std::vector<Weight> closest(n, infinity());   // to any chosen landmark
+        size_t first = 0;
+        while(first < n && !eligible[first])
+          ++first;
+        if(first < n) {
+          dijkstra_search(_graph, _graph.vertex_at(first), (vertex*)nullptr, work, _weight);
+          for(size_t v = 0; v < n; ++v)
+            closest[v] = work.forward.distance(_graph.vertex_at(v));
+        }
+
+        for(size_t l = 0; l < _count; ++l) {
+          // farthest from the chosen landmarks, unreachable ones first
+          size_t pick = n;
+          for(size_t v = 0; v < n; ++v)
+            if(eligible[v] && (pick == n || closest[v] > closest[pick]))
+              pick = v;
+          eligible[pick] = false;
+          vertex* mark = _graph.vertex_at(pick);
+          m_landmarks.push_back(mark);
+
+          dijkstra_search(_graph, mark, (vertex*)nullptr, work, _weight);
+          for(size_t v = 0; v < n; ++v) {
+            Weight dist = work.forward.distance(_graph.vertex_at(v));
+            m_dist[(v * _count + l) * 2] = dist;
+            closest[v] = (l == 0) ? dist : std::min(closest[v], dist);
+          }
+
+          reverse_distances(_graph, mark, work, _weight);
+          for(size_t v = 0; v < n; ++v)
+            m_dist[(v * _count + l) * 2 + 1] = work.backward.distance(_graph.vertex_at(v));
+        }
+      }
+      /// @}
+
+      size_t size() const { return m_count; }
+      vertex* landmark(size_t _l) const { return m_landmarks[_l]; }
+
+      /// @return Lower bound on the distance from _vert to _target, the
+      ///         maximum Weight when _target is known to be unreachable.
+      Weight lower_bound(const vertex* _vert, const vertex* _target) const {
+        const Weight* from = &m_dist[_vert->index() * m_count * 2];
+        const Weight* to = &m_dist[_target->index() * m_count * 2];
+        Weight bound = Weight(0);
+        for(size_t l = 0; l < 2 * m_count; l += 2) {
+          Weight inf = infinity();
+          // L reaches v but not t, or t reaches L but v does not; either
+          // way no path from v to t exists
+          if((from[l] != inf && to[l] == inf) || (from[l + 1] == inf && to[l + 1] != inf))
+            return inf;
+          // d(L, t) <= d(L, v) + d(v, t)
+          if(from[l] != inf && to[l] > from[l])
+            bound = std::max(bound, Weight(to[l] - from[l]));
+          // d(v, L) <= d(v, t) + d(t, L)
+          if(to[l + 1] != inf && from[l + 1] > to[l + 1])
+            bound = std::max(bound, Weight(from[l + 1] - to[l + 1]));
+        }
+        return bound;
+      }
+
+      heuristic to(const vertex* _target) const { return heuristic(this, _target); }
+
+    private:
+      static Weight infinity() { return std::numeric_limits<Weight>::max(); }
+
+      // distances from every vertex to _mark, in work.backward
+      template<typename WeightFunc>
+      static void reverse_distances(const GraphType& _graph, vertex* _mark,
+                                    path_workspace<GraphType, Weight>& _work,
+                                    WeightFunc _weight) {
+        auto& backward = _work.backward;
+        backward.start(_graph, _mark);
+        while(auto v = backward.pop()) {
+          Weight dist = backward.distance(v);
+          for(auto iter = _graph.in_begin(v); iter != _graph.in_end(v); ++iter) {
+            Weight next = dist + Weight(_weight(*iter));
+            backward.relax(_graph.source(*iter), next, v, next);
+          }
+        }
+      }
+
+      std::vector<vertex*> m_landmarks;
+      std::vector<Weight> m_dist;     // [(v * size() + l) * 2 + {from L, to L}]
+      size_t m_count;
+  };
+}
+
+#endif // SHORTEST_PATH_H
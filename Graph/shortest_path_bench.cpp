@@ -0,0 +1,80 @@
+#include "graph.h"
+#include "shortest_path.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Random point to point queries on a road like grid with random travel
+// times: a full Dijkstra per query against the point to point searches.
+// usage: shortest_path_bench [side] [queries] [landmarks]
+
+typedef nostd::graph<int, unsigned> graph_type;
+typedef graph_type::vertex vertex;
+
+template<typename Func>
+void measure(const char* _name, size_t _queries, std::vector<unsigned>& _dist,
+             nostd::path_workspace<graph_type>& _work, Func _func) {
+  size_t settled = 0;
+  auto start = std::chrono::steady_clock::now();
+  for(size_t q = 0; q < _queries; ++q) {
+    _dist.push_back(_func(q));
+    settled += _work.settled;
+  }
+  auto stop = std::chrono::steady_clock::now();
+  std::cout << _name << " "
+            << std::chrono::duration<double, std::milli>(stop - start).count() / _queries
+            << " ms/query, settled " << settled / _queries << "\n";
+}
+
+int main(int argc, char** argv) {
+  size_t side = (argc > 1) ? atoi(argv[1]) : 300;
+  size_t queries = (argc > 2) ? atoi(argv[2]) : 100;
+  size_t count = (argc > 3) ? atoi(argv[3]) : 16;
+
+  std::mt19937 rng(42);
+  graph_type g;
+  std::vector<vertex*> verts;
+  for(size_t i = 0; i < side * side; ++i)
+    verts.push_back(g.insert_vertex(int(i)));
+  for(size_t y = 0; y < side; ++y)
+    for(size_t x = 0; x < side; ++x) {
+      size_t c = y * side + x;
+      if(x + 1 < side)
+        g.insert_undirected(verts[c], verts[c + 1], 10 + rng() % 90);
+      if(y + 1 < side)
+        g.insert_undirected(verts[c], verts[c + side], 10 + rng() % 90);
+    }
+
+  std::vector<std::pair<vertex*, vertex*>> pairs;
+  for(size_t q = 0; q < queries; ++q)
+    pairs.push_back(std::make_pair(verts[rng() % verts.size()],
+                                   verts[rng() % verts.size()]));
+
+  auto start = std::chrono::steady_clock::now();
+  nostd::landmarks<graph_type> marks(g, count);
+  auto stop = std::chrono::steady_clock::now();
+  std::cout << "vertices " << g.num_vertices() << " edges " << g.num_edges()
+            << " landmarks " << count << " in "
+            << std::chrono::duration<double, std::milli>(stop - start).count()
+            << " ms\n";
+
+  nostd::path_workspace<graph_type> work;
+  std::vector<unsigned> full, early, bidir, astar;
+  measure("full dijkstra ", queries, full, work, [&](size_t q) {
+    nostd::dijkstra_search(g, pairs[q].first, (vertex*)nullptr, work);
+    return work.forward.distance(pairs[q].second);
+  });
+  measure("dijkstra      ", queries, early, work, [&](size_t q) {
+    return nostd::dijkstra_search(g, pairs[q].first, pairs[q].second, work);
+  });
+  measure("bidirectional ", queries, bidir, work, [&](size_t q) {
+    return nostd::bidirectional_dijkstra_search(g, pairs[q].first, pairs[q].second, work);
+  });
+  measure("astar alt     ", queries, astar, work, [&](size_t q) {
+    return nostd::astar_search(g, pairs[q].first, pairs[q].second, work,
+                               marks.to(pairs[q].second));
+  });
+  return (full == early && full == bidir && full == astar) ? 0 : 1;
+}
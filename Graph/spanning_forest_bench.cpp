@@ -0,0 +1,51 @@
+#include "graph.h"
+#include "spanning_tree.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Minimum spanning forest of a random sparse graph with random weights:
+// Boruvka and filter-Kruskal, serial and on an executor.
+// usage: spanning_forest_bench [vertices] [degree] [threads]
+
+typedef nostd::graph<int, unsigned> graph_type;
+typedef graph_type::edge edge;
+
+template<typename Func>
+void measure(const char* _name, Func _func) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<edge*> forest = _func();
+  auto stop = std::chrono::steady_clock::now();
+  unsigned long weight = 0;
+  for(auto e : forest)
+    weight += e->property();
+  std::cout << _name << " "
+            << std::chrono::duration<double, std::milli>(stop - start).count()
+            << " ms, edges " << forest.size() << " weight " << weight << "\n";
+}
+
+int main(int argc, char** argv) {
+  size_t n = (argc > 1) ? atoi(argv[1]) : 200000;
+  size_t degree = (argc > 2) ? atoi(argv[2]) : 8;
+  size_t threads = (argc > 3) ? atoi(argv[3]) : 4;
+
+  std::mt19937 rng(42);
+  graph_type g;
+  std::vector<graph_type::vertex*> verts;
+  for(size_t i = 0; i < n; ++i)
+    verts.push_back(g.insert_vertex(int(i)));
+  for(size_t i = 0; i < n * degree / 2; ++i)
+    g.insert_undirected(verts[rng() % n], verts[rng() % n], rng() % 1000000);
+  std::cout << "vertices " << g.num_vertices() << " edges " << g.num_edges() << "\n";
+
+  nostd::executor exec(threads);
+  measure("boruvka", [&] { return nostd::boruvka_spanning_forest(g); });
+  measure("boruvka parallel", [&] { return nostd::boruvka_spanning_forest(g, &exec); });
+  measure("filter_kruskal", [&] { return nostd::filter_kruskal_spanning_forest(g); });
+  measure("filter_kruskal parallel", [&] {
+    return nostd::filter_kruskal_spanning_forest(g, &exec);
+  });
+  return 0;
+}
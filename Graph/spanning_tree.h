@@ -0,0 +1,237 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @name Minimum Spanning Forest
+/// @group Graph Algorithms
+///
+/// @note Minimum spanning forests, treating every edge as undirected.
+///
+///       boruvka_spanning_forest        - rounds in which every component
+///                                        picks its lightest leaving edge
+///                                        in parallel, then all of them
+///                                        are merged in a shared
+///                                        union_find
+///       filter_kruskal_spanning_forest - Kruskal on a quicksort like
+///                                        partition of the edges; the
+///                                        heavy side is filtered against
+///                                        the forest built from the light
+///                                        side before it is sorted
+///
+///       Both return the forest as a list of edges of the graph. A forest
+///       edge joins two components that were separate, so the two edges
+///       insert_undirected creates for one connection are never both
+///       taken. Ties between equal weights are broken by edge index, so
+///       both algorithms return the same forest. spanning_forest_graph
+///       turns the list into a new graph.
+///
+///////////////////////////////////////////////////////////////////////////////
+#ifndef SPANNING_TREE_H
+#define SPANNING_TREE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../Parallel/executor.h"
+#include "../Parallel/union_find.h"
+#include "instrument.h"
+#include "property_map.h"
+
+namespace nostd {
+
+  /// @brief Edge considered for a spanning forest
+  template<typename Edge, typename Weight>
+  struct forest_candidate {
+    Weight weight;
+    uint32_t source;
+    uint32_t target;
+    Edge* edge;
+
+    /// @brief Strict order on weight, then edge index
+    bool operator<(const forest_candidate& _other) const {
+      if(weight != _other.weight)
+        return weight < _other.weight;
+      return edge->index() < _other.edge->index();
+    }
+  };
+
+  /// @return Every edge of _graph other than self loops, as candidates
+  template<typename GraphType, typename WeightFunc>
+  auto spanning_candidates(const GraphType& _graph, executor* _exec,
+                           WeightFunc _weight) {
+    typedef typename GraphType::edge edge;
+    typedef std::decay_t<decltype(_weight(std::declval<edge*>()))> Weight;
+
+    std::vector<forest_candidate<edge, Weight>> candidates(_graph.num_edges());
+    parallel_for(_exec, 0, candidates.size(), [&](size_t i) {
+      edge* e = _graph.edge_at(i);
+      auto& c = candidates[i];
+      c.edge = e;
+      c.source = uint32_t(_graph.source(e)->index());
+      c.target = uint32_t(_graph.target(e)->index());
+      c.weight = _weight(e);
+      if(c.source == c.target || !_graph.contains(e))
+        c.edge = nullptr;
+    }, 4096);
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                    [](const forest_candidate<edge, Weight>& _c) {
+                                      return _c.edge == nullptr;
+                                    }),
+                     candidates.end());
+    return candidates;
+  }
+
+  /// @brief Parallel Boruvka. Each round finds the lightest candidate
+  ///        leaving every component with an atomic minimum, merges along
+  ///        them and drops the candidates that became internal.
+  /// @return Edges of a minimum spanning forest
+  template<typename GraphType, typename WeightFunc = edge_weight>
+  std::vector<typename GraphType::edge*>
+  boruvka_spanning_forest(const GraphType& _graph, executor* _exec = nullptr,
+                          WeightFunc _weight = WeightFunc()) {
+    NOSTD_ALGO_RUN(SPANNING_FOREST);
+    const uint64_t NONE = std::numeric_limits<uint64_t>::max();
+    size_t n = _graph.num_vertices();
+    size_t slots = (_exec == nullptr) ? 1 : _exec->num_threads() + 1;
+
+    auto candidates = spanning_candidates(_graph, _exec, _weight);
+    union_find sets(n);
+    std::vector<std::atomic<uint64_t>> lightest(n);
+    for(auto& l : lightest)
+      l.store(NONE, std::memory_order_relaxed);
+    std::vector<std::vector<typename GraphType::edge*>> found(slots);
+    std::vector<typename GraphType::edge*> forest;
+
+    while(!candidates.empty()) {
+      NOSTD_ALGO_EDGES(candidates.size());
+      std::vector<char> internal(candidates.size(), 0);
+
+      parallel_for(_exec, 0, candidates.size(), [&](size_t i) {
+        const auto& c = candidates[i];
+        uint32_t a = sets.find(c.source);
+        uint32_t b = sets.find(c.target);
+        if(a == b) {
+          internal[i] = 1;
+          return;
+        }
+        for(uint32_t root : {a, b}) {
+          uint64_t current = lightest[root].load(std::memory_order_relaxed);
+          while((current == NONE || c < candidates[current]) &&
+                !lightest[root].compare_exchange_weak(current, i))
+            ;
+        }
+      }, 1024);
+
+      // a candidate picked by both of its components is only merged once
+      parallel_for(_exec, 0, n, [&](size_t v) {
+        uint64_t pick = lightest[v].load(std::memory_order_relaxed);
+        if(pick == NONE)
+          return;
+        lightest[v].store(NONE, std::memory_order_relaxed);
+        const auto& c = candidates[pick];
+        if(sets.unite(c.source, c.target))
+          found[(_exec == nullptr) ? 0 : _exec->worker_id()].push_back(c.edge);
+      }, 4096);
+
+      size_t before = forest.size();
+      for(auto& slot : found) {
+        forest.insert(forest.end(), slot.begin(), slot.end());
+        slot.clear();
+      }
+      if(forest.size() == before)
+        break;
+
+      size_t kept = 0;
+      for(size_t i = 0; i < candidates.size(); ++i)
+        if(!internal[i])
+          candidates[kept++] = candidates[i];
+      candidates.resize(kept);
+    }
+    NOSTD_ALGO_VERTICES(forest.size());
+    return forest;
+  }
+
+  /// @brief One level of filter-Kruskal over [_first, _last)
+  template<typename Iter, typename Edge>
+  void filter_kruskal_step(Iter _first, Iter _last, union_find& _sets,
+                           std::vector<Edge*>& _forest, executor* _exec,
+                           size_t _base_case) {
+    typedef typename std::iterator_traits<Iter>::value_type candidate;
+    size_t size = _last - _first;
+
+    if(size > _base_case) {
+      // median of three as pivot
+      candidate a = _first[0], b = _first[size / 2], c = _last[-1];
+      if(b < a)
+        std::swap(a, b);
+      if(c < b)
+        b = (c < a) ? a : c;
+      Iter middle = std::partition(_first, _last,
+                                   [&](const candidate& _c) { return !(b < _c); });
+
+      if(middle != _last) {
+        filter_kruskal_step(_first, middle, _sets, _forest, _exec, _base_case);
+
+        // heavy candidates already inside one tree can never be taken
+        std::vector<char> keep(_last - middle);
+        parallel_for(_exec, 0, keep.size(), [&](size_t i) {
+          keep[i] = !_sets.same(middle[i].source, middle[i].target);
+        }, 4096);
+        Iter end = middle;
+        for(size_t i = 0; i < keep.size(); ++i)
+          if(keep[i])
+            *end++ = middle[i];
+
+        filter_kruskal_step(middle, end, _sets, _forest, _exec, _base_case);
+        return;
+      }
+    }
+
+    parallel_sort(_exec, _first, _last, std::less<candidate>());
+    for(Iter iter = _first; iter != _last; ++iter)
+      if(_sets.unite(iter->source, iter->target))
+        _forest.push_back(iter->edge);
+  }
+
+  /// @brief Filter-Kruskal. Ranges of at most _base_case candidates are
+  ///        sorted with parallel_sort and scanned; by default the base
+  ///        case is the number of vertices, at least 1024.
+  /// @return Edges of a minimum spanning forest
+  template<typename GraphType, typename WeightFunc = edge_weight>
+  std::vector<typename GraphType::edge*>
+  filter_kruskal_spanning_forest(const GraphType& _graph, executor* _exec = nullptr,
+                                 WeightFunc _weight = WeightFunc(),
+                                 size_t _base_case = 0) {
+    NOSTD_ALGO_RUN(SPANNING_FOREST);
+    if(_base_case == 0)
+      _base_case = std::max<size_t>(_graph.num_vertices(), 1024);
+
+    auto candidates = spanning_candidates(_graph, _exec, _weight);
+    NOSTD_ALGO_EDGES(candidates.size());
+    union_find sets(_graph.num_vertices());
+    std::vector<typename GraphType::edge*> forest;
+    filter_kruskal_step(candidates.begin(), candidates.end(), sets, forest,
+                        _exec, _base_case);
+    NOSTD_ALGO_VERTICES(forest.size());
+    return forest;
+  }
+
+  /// @brief New graph holding a copy of every vertex of _graph, in the same
+  ///        index order, and every forest edge as an undirected pair.
+  template<typename GraphType>
+  GraphType spanning_forest_graph(const GraphType& _graph,
+                                  const std::vector<typename GraphType::edge*>& _forest) {
+    GraphType result;
+    for(size_t i = 0; i < _graph.num_vertices(); ++i)
+      result.emplace_vertex(_graph.vertex_at(i)->property());
+    for(auto e : _forest)
+      result.insert_undirected(result.vertex_at(e->source()->index()),
+                               result.vertex_at(e->target()->index()),
+                               e->property());
+    return result;
+  }
+}
+
+#endif // SPANNING_TREE_H
@@ -0,0 +1,289 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @name Traversal Ranges
+/// @group Graph Algorithms
+///
+/// @note Lazy breadth first and depth first traversals as input ranges:
+///
+///           for(auto v : nostd::bfs_range(g, root))
+///             if(++seen == k)
+///               break;
+///
+///       The traversal is a resumable state machine advanced by the
+///       iterator. A vertex's neighbors are scanned only when the iterator
+///       moves past it, so stopping early leaves the rest of the graph
+///       untouched. bfs_range yields vertices in the order of
+///       breath_first_search and dfs_range in the discover order of
+///       depth_first_search.
+///
+///       The queue, stack and labels live in a traversal_workspace. The
+///       queue (or stack) is reserved for the whole graph when a traversal
+///       starts, so it is allocated once. A range owns its workspace unless
+///       given one to borrow; a borrowed workspace keeps its buffers, and
+///       its labels are stamped per traversal, so restarting costs nothing
+///       beyond the vertices reached.
+///
+///       Iterators are single pass and satisfy std::ranges::input_range
+///       when compiled as C++20, so the ranges compose with the standard
+///       views (std::views::take, std::views::filter, ...). The graph, or
+///       a view from graph_view.h, must not change during a traversal.
+///
+///////////////////////////////////////////////////////////////////////////////
+#ifndef TRAVERSAL_RANGE_H
+#define TRAVERSAL_RANGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "property_map.h"
+
+namespace nostd {
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief Buffers of bfs_range and dfs_range.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename GraphType>
+  class traversal_workspace {
+    public:
+      typedef typename GraphType::vertex vertex;
+      typedef typename GraphType::adj_iterator adj_iterator;
+
+      /// @brief Forgets the previous traversal
+      void start(const GraphType& _graph) {
+        if(m_stamp.size() != _graph.num_vertices() ||
+           m_current == std::numeric_limits<uint32_t>::max()) {
+          m_stamp.reset(_graph, 0);
+          m_current = 0;
+        }
+        ++m_current;
+        queue.clear();
+        stack.clear();
+        head = 0;
+        expanded = 0;
+      }
+
+      bool seen(const vertex* _vert) const { return m_stamp[_vert] == m_current; }
+      void mark(const vertex* _vert) { m_stamp[_vert] = m_current; }
+
+      std::vector<std::pair<vertex*, uint32_t>> queue;      // vertex, depth
+      std::vector<std::pair<vertex*, adj_iterator>> stack;
+      size_t head{0};         // front of the queue
+      size_t expanded{0};     // vertices moved past
+
+    private:
+      vertex_property_map<uint32_t> m_stamp;
+      uint32_t m_current{0};
+  };
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief State shared by the traversal ranges; holds the owned or
+  ///        borrowed workspace.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename GraphType>
+  class traversal_base {
+    public:
+      /// @return Vertices the traversal has moved past; no other vertex has
+      ///         had its neighbors scanned.
+      size_t expanded() const { return m_work->expanded; }
+
+    protected:
+      traversal_base(const GraphType& _graph):
+                     m_graph(&_graph), m_work(&m_own) {}
+
+      traversal_base(const GraphType& _graph, traversal_workspace<GraphType>& _work):
+                     m_graph(&_graph), m_work(&_work) {}
+
+      traversal_base(traversal_base&& _other):
+                     m_graph(_other.m_graph), m_own(std::move(_other.m_own)),
+                     m_work(_other.m_work == &_other.m_own ? &m_own : _other.m_work) {}
+
+      traversal_base& operator=(traversal_base&& _other) {
+        bool owned = _other.m_work == &_other.m_own;
+        m_graph = _other.m_graph;
+        m_own = std::move(_other.m_own);
+        m_work = owned ? &m_own : _other.m_work;
+        return *this;
+      }
+
+      const GraphType* m_graph;
+      traversal_workspace<GraphType> m_own;
+      traversal_workspace<GraphType>* m_work;
+  };
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief Single pass iterator over a traversal range; end is the default
+  ///        constructed iterator.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename Range>
+  class traversal_iterator {
+    public:
+      typedef std::input_iterator_tag iterator_category;
+      typedef typename Range::vertex* value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef void pointer;
+      typedef value_type reference;
+
+      traversal_iterator(Range* _range = nullptr): m_range(_range) {
+        if(m_range != nullptr && m_range->current() == nullptr)
+          m_range = nullptr;
+      }
+
+      reference operator*() const { return m_range->current(); }
+
+      /// @return Hops from the root (bfs_range) or stack depth (dfs_range)
+      uint32_t depth() const { return m_range->depth(); }
+
+      traversal_iterator& operator++() {
+        m_range->advance();
+        if(m_range->current() == nullptr)
+          m_range = nullptr;
+        return *this;
+      }
+
+      void operator++(int) { ++*this; }
+
+      bool operator==(const traversal_iterator& _other) const {
+        return m_range == _other.m_range;
+      }
+      bool operator!=(const traversal_iterator& _other) const {
+        return m_range != _other.m_range;
+      }
+
+    private:
+      Range* m_range;
+  };
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief Lazy breadth first traversal from a root.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename GraphType>
+  class bfs_range : public traversal_base<GraphType> {
+    public:
+      typedef typename GraphType::vertex vertex;
+      typedef traversal_iterator<bfs_range> iterator;
+
+      /// @name constructors
+      /// @{
+      bfs_range(const GraphType& _graph, vertex* _root):
+                traversal_base<GraphType>(_graph) { start(_root); }
+
+      bfs_range(const GraphType& _graph, vertex* _root,
+                traversal_workspace<GraphType>& _work):
+                traversal_base<GraphType>(_graph, _work) { start(_root); }
+
+      bfs_range(bfs_range&&) = default;
+      bfs_range& operator=(bfs_range&&) = default;
+      /// @}
+
+      iterator begin() { return iterator(this); }
+      iterator end() { return iterator(); }
+
+    private:
+      void start(vertex* _root) {
+        auto& work = *this->m_work;
+        work.start(*this->m_graph);
+        work.queue.reserve(this->m_graph->num_vertices());
+        if(_root != nullptr) {
+          work.mark(_root);
+          work.queue.push_back(std::make_pair(_root, 0u));
+        }
+      }
+
+      vertex* current() const {
+        auto& work = *this->m_work;
+        return (work.head < work.queue.size()) ? work.queue[work.head].first : nullptr;
+      }
+
+      uint32_t depth() const { return this->m_work->queue[this->m_work->head].second; }
+
+      // scans the neighbors of the front vertex and pops it
+      void advance() {
+        auto& work = *this->m_work;
+        auto front = work.queue[work.head++];
+        ++work.expanded;
+        auto& graph = *this->m_graph;
+        for(auto iter = graph.out_begin(front.first); iter != graph.out_end(front.first); ++iter) {
+          auto target = graph.target(*iter);
+          if(!work.seen(target)) {
+            work.mark(target);
+            work.queue.push_back(std::make_pair(target, front.second + 1));
+          }
+        }
+      }
+
+      friend class traversal_iterator<bfs_range>;
+  };
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief Lazy depth first traversal from a root, in preorder.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename GraphType>
+  class dfs_range : public traversal_base<GraphType> {
+    public:
+      typedef typename GraphType::vertex vertex;
+      typedef traversal_iterator<dfs_range> iterator;
+
+      /// @name constructors
+      /// @{
+      dfs_range(const GraphType& _graph, vertex* _root):
+                traversal_base<GraphType>(_graph) { start(_root); }
+
+      dfs_range(const GraphType& _graph, vertex* _root,
+                traversal_workspace<GraphType>& _work):
+                traversal_base<GraphType>(_graph, _work) { start(_root); }
+
+      dfs_range(dfs_range&&) = default;
+      dfs_range& operator=(dfs_range&&) = default;
+      /// @}
+
+      iterator begin() { return iterator(this); }
+      iterator end() { return iterator(); }
+
+    private:
+      void start(vertex* _root) {
+        auto& work = *this->m_work;
+        work.start(*this->m_graph);
+        work.stack.reserve(this->m_graph->num_vertices());
+        if(_root != nullptr) {
+          work.mark(_root);
+          work.stack.push_back(std::make_pair(_root, this->m_graph->out_begin(_root)));
+        }
+      }
+
+      vertex* current() const {
+        auto& stack = this->m_work->stack;
+        return stack.empty() ? nullptr : stack.back().first;
+      }
+
+      uint32_t depth() const { return uint32_t(this->m_work->stack.size() - 1); }
+
+      // resumes the scan of the deepest vertex with unscanned edges until
+      // an undiscovered vertex turns up
+      void advance() {
+        auto& work = *this->m_work;
+        auto& stack = work.stack;
+        auto& graph = *this->m_graph;
+        ++work.expanded;
+        while(!stack.empty()) {
+          auto& top = stack.back();
+          if(top.second == graph.out_end(top.first)) {
+            stack.pop_back();
+            continue;
+          }
+          auto target = graph.target(*top.second++);
+          if(!work.seen(target)) {
+            work.mark(target);
+            stack.push_back(std::make_pair(target, graph.out_begin(target)));
+            return;
+          }
+        }
+      }
+
+      friend class traversal_iterator<dfs_range>;
+  };
+}
+
+#endif // TRAVERSAL_RANGE_H
@@ -8,6 +8,10 @@
 ///       concept. This will be used by all graph algorithms for returning
 ///       the results of the algorthim back to the user.
 ///
+///       Every action does nothing by default, a visitor only needs to
+///       define the actions it cares about. When an algorithm is given an
+///       executor the actions may be called from several threads at once.
+///
 ///////////////////////////////////////////////////////////////////////////////
 #ifndef VISITOR_H
 #define VISITOR_H
@@ -18,41 +22,46 @@ namespace nostd {
     public:
       /// @name Constructor
       /// @{
-      visitor(Visitor_Data& _vis): m_vis(_vis) {}
+      base_visitor(const Visitor_Data& _vis = Visitor_Data()): m_vis(_vis) {}
+      /// @}
+
+      /// @name Data Access
+      /// @{
+      Visitor_Data& data() { return m_vis; }
+      const Visitor_Data& data() const { return m_vis; }
       /// @}
-        
 
       /// @name Actions
       /// @{
-      template<typename V, typename Graph> 
-      void initialize_vertex(V _vert, Graph& _graph) = 0;
+      template<typename V, typename Graph>
+      void initialize_vertex(V, const Graph&) {}
 
-      template<typename V, typename Graph> 
-      void discover_vertex(V _vert, Graph& _graph) = 0;   
+      template<typename V, typename Graph>
+      void discover_vertex(V, const Graph&) {}
 
-      template<typename V, typename Graph> 
-      void examine_vertex(V _vert, Graph& _graph) = 0;
+      template<typename V, typename Graph>
+      void examine_vertex(V, const Graph&) {}
 
-      template<typename E, typename Graph> 
-      void examine_edge(E _edge, Graph& _graph) = 0;
+      template<typename E, typename Graph>
+      void examine_edge(E, const Graph&) {}
 
-      template<typename E, typename Graph> 
-      void tree_edge(E _edge, Graph& _graph) = 0;
+      template<typename E, typename Graph>
+      void tree_edge(E, const Graph&) {}
 
-      template<typename E, typename Graph> 
-      void non_tree_edge(E _edge, Graph& _graph) = 0;
+      template<typename E, typename Graph>
+      void non_tree_edge(E, const Graph&) {}
 
-      template<typename E, typename Graph> 
-      void grey_target(E _edge, Graph& _graph) = 0;
+      template<typename E, typename Graph>
+      void grey_target(E, const Graph&) {}
 
-      template<typename E, typename Graph> 
-      void black_target(E _edge, Graph& _graph) = 0;
+      template<typename E, typename Graph>
+      void black_target(E, const Graph&) {}
 
-      template<typename V, typename Graph> 
-      void finish_vertex(V _vert, Graph& _graph) = 0;
+      template<typename V, typename Graph>
+      void finish_vertex(V, const Graph&) {}
 
       /// @}
-    private:
+    protected:
       Visitor_Data m_vis;
   };
 
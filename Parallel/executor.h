@@ -0,0 +1,630 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @name Executor
+/// @group Parallel
+///
+/// @note Work-stealing thread pool shared by all of the nostd algorithms.
+///       Every worker owns a Chase-Lev deque: it pushes and pops tasks at
+///       the bottom of its own deque and steals from the top of the other
+///       workers' deques when it runs dry. Tasks submitted from a thread
+///       that is not a worker go through a small shared injection queue.
+///
+///       Two interfaces are provided on top of the pool:
+///           parallel_for - index ranges split by a grain size using a
+///                          static, dynamic, or guided schedule.
+///           task_group   - fork-join; run() forks a task and wait()
+///                          joins, executing pending tasks while waiting.
+///                          The first exception thrown by a task is
+///                          rethrown from wait() once every task finished.
+///
+///       parallel_sort is a fork-join merge sort built on task_group.
+///
+///       Algorithms take an executor* which defaults to nullptr; when no
+///       executor is given they run serially on the calling thread.
+///
+///       Pinned workers are spread round robin over the NUMA nodes, so
+///       node local work can be sent to the workers of one node with
+///       task_group::run_on. Those tasks are never stolen.
+///
+///////////////////////////////////////////////////////////////////////////////
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "numa_topology.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace nostd {
+
+  enum Schedule { STATIC, DYNAMIC, GUIDED };
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief Chase-Lev work stealing deque. The owner calls push and pop, any
+  ///        other thread may call steal. The ring buffer grows on demand;
+  ///        old rings are kept until destruction since a thief may still be
+  ///        reading from them.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename T>
+  class work_deque {
+    public:
+      /// @name constructors
+      /// @{
+      work_deque(size_t _capacity = 64) {
+        m_ring.store(new ring(_capacity), std::memory_order_relaxed);
+      }
+
+      ~work_deque() {
+        delete m_ring.load(std::memory_order_relaxed);
+        for(auto& r : m_retired)
+          delete r;
+      }
+
+      work_deque(const work_deque&) = delete;
+      work_deque& operator=(const work_deque&) = delete;
+      /// @}
+
+      /// @name Owner Operations
+      /// @{
+      void push(T _item) {
+        int64_t b = m_bottom.load(std::memory_order_relaxed);
+        int64_t t = m_top.load(std::memory_order_acquire);
+        ring* r = m_ring.load(std::memory_order_relaxed);
+        if(b - t > int64_t(r->capacity()) - 1)
+          r = grow(r, b, t);
+        r->put(b, _item);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+      }
+
+      bool pop(T& _item) {
+        int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+        ring* r = m_ring.load(std::memory_order_relaxed);
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = m_top.load(std::memory_order_relaxed);
+
+        if(t > b) {
+          m_bottom.store(b + 1, std::memory_order_relaxed);
+          return false;
+        }
+
+        _item = r->get(b);
+        if(t == b) {
+          // last element, race against the thieves for it
+          bool won = m_top.compare_exchange_strong(t, t + 1,
+                                                   std::memory_order_seq_cst,
+                                                   std::memory_order_relaxed);
+          m_bottom.store(b + 1, std::memory_order_relaxed);
+          return won;
+        }
+        return true;
+      }
+      /// @}
+
+      /// @name Thief Operations
+      /// @{
+      bool steal(T& _item) {
+        int64_t t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = m_bottom.load(std::memory_order_acquire);
+        if(t >= b)
+          return false;
+
+        ring* r = m_ring.load(std::memory_order_acquire);
+        _item = r->get(t);
+        return m_top.compare_exchange_strong(t, t + 1,
+                                             std::memory_order_seq_cst,
+                                             std::memory_order_relaxed);
+      }
+      /// @}
+
+    private:
+      class ring {
+        public:
+          ring(size_t _capacity): m_mask(_capacity - 1),
+                                  m_data(new std::atomic<T>[_capacity]) {}
+          ~ring() { delete [] m_data; }
+
+          size_t capacity() const { return m_mask + 1; }
+
+          T get(int64_t _i) const {
+            return m_data[_i & m_mask].load(std::memory_order_relaxed);
+          }
+
+          void put(int64_t _i, T _item) {
+            m_data[_i & m_mask].store(_item, std::memory_order_relaxed);
+          }
+
+        private:
+          size_t m_mask;
+          std::atomic<T>* m_data;
+      };
+
+      ring* grow(ring* _old, int64_t _bottom, int64_t _top) {
+        ring* r = new ring(_old->capacity() * 2);
+        for(int64_t i = _top; i < _bottom; ++i)
+          r->put(i, _old->get(i));
+        m_retired.push_back(_old);
+        m_ring.store(r, std::memory_order_release);
+        return r;
+      }
+
+      std::atomic<int64_t> m_top{0};
+      std::atomic<int64_t> m_bottom{0};
+      std::atomic<ring*> m_ring;
+      std::vector<ring*> m_retired;       // rings replaced by grow
+  };
+
+  class task_group;
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief Work-stealing thread pool.
+  /////////////////////////////////////////////////////////////////////////////
+  class executor {
+    public:
+      /// @name constructors
+      /// @{
+
+      /// @param _threads Number of worker threads; 0 uses one per core.
+      /// @param _pin Pin the workers to cores, alternating between the
+      ///        nodes of _topo.
+      executor(size_t _threads = 0, bool _pin = false,
+               const numa_topology& _topo = numa_topology::system()) {
+        if(_threads == 0)
+          _threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        m_pinned = _pin;
+        m_node_workers.resize(_topo.num_nodes());
+        for(size_t i = 0; i < _threads; ++i) {
+          m_workers.emplace_back(new worker(this, i));
+          if(_pin)
+            place(m_workers.back(), _topo);
+        }
+        for(size_t i = 0; i < _threads; ++i)
+          m_workers[i]->thread = std::thread(&executor::worker_loop, this, i);
+      }
+
+      ~executor() {
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          m_stop = true;
+        }
+        m_sleep.notify_all();
+        for(auto& w : m_workers)
+          w->thread.join();
+        for(auto& w : m_workers)
+          delete w;
+      }
+
+      executor(const executor&) = delete;
+      executor& operator=(const executor&) = delete;
+      /// @}
+
+      /// @name Pool Information
+      /// @{
+      size_t num_threads() const { return m_workers.size(); }
+
+      bool pinned() const { return m_pinned; }
+
+      /// @return The index of the calling worker in [0, num_threads()) or
+      ///         num_threads() when called from a thread outside the pool.
+      ///         Useful for indexing per-thread scratch buffers sized
+      ///         num_threads() + 1.
+      size_t worker_id() const {
+        worker* w = current();
+        if(w != nullptr && w->owner == this)
+          return w->id;
+        return num_threads();
+      }
+
+      size_t num_nodes() const { return m_node_workers.size(); }
+
+      /// @return The workers pinned to cpus of _node; empty when the pool
+      ///         is not pinned.
+      const std::vector<size_t>& node_workers(size_t _node) const {
+        return m_node_workers[_node];
+      }
+      /// @}
+
+      /// @name Parallel Loops
+      /// @{
+
+      /// @brief Calls _func(i) for every i in [_begin, _end).
+      /// @param _grain Minimum number of indices handed out at once; 0
+      ///        picks one based on the range and the number of threads.
+      template<typename Func>
+      void parallel_for(size_t _begin, size_t _end, Func _func,
+                        size_t _grain = 0, Schedule _sched = STATIC);
+      /// @}
+
+    private:
+      friend class task_group;
+
+      struct task {
+        std::function<void()> func;
+        task_group* group;
+      };
+
+      struct worker {
+        worker(executor* _owner, size_t _id): owner(_owner), id(_id) {}
+
+        executor* owner;
+        size_t id;
+        int cpu{-1};
+        work_deque<task*> tasks;
+        std::thread thread;
+
+        std::mutex mailbox_mutex;
+        std::deque<task*> mailbox;          // tasks bound to this worker
+        std::atomic<size_t> mailed{0};
+      };
+
+      // next free cpu on the next node in round robin order
+      void place(worker* _worker, const numa_topology& _topo) {
+        size_t nodes = _topo.num_nodes();
+        size_t node = _worker->id % nodes;
+        const std::vector<int>& cpus = _topo.cpus(node);
+        _worker->cpu = cpus[(_worker->id / nodes) % cpus.size()];
+        m_node_workers[node].push_back(_worker->id);
+      }
+
+      static worker*& current() {
+        static thread_local worker* tl_worker = nullptr;
+        return tl_worker;
+      }
+
+      void submit(task* _task) {
+        worker* w = current();
+        if(w != nullptr && w->owner == this)
+          w->tasks.push(_task);
+        else {
+          std::lock_guard<std::mutex> lock(m_inject_mutex);
+          m_inject.push_back(_task);
+        }
+        // seq_cst pairs with the idle count in worker_loop: either the
+        // sleeper sees the task or this sees the sleeper
+        m_queued.fetch_add(1, std::memory_order_seq_cst);
+        if(m_idle.load(std::memory_order_seq_cst) > 0) {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          m_sleep.notify_one();
+        }
+      }
+
+      void submit_to(size_t _worker, task* _task) {
+        worker* w = m_workers[_worker];
+        {
+          std::lock_guard<std::mutex> lock(w->mailbox_mutex);
+          w->mailbox.push_back(_task);
+        }
+        w->mailed.fetch_add(1, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_sleep.notify_all();
+      }
+
+      /// @brief Finds a task for the calling thread: its own deque first,
+      ///        then its mailbox, then the injection queue, then steals
+      ///        from the others.
+      task* acquire(worker* _self) {
+        task* t = nullptr;
+        if(_self != nullptr && _self->tasks.pop(t))
+          return taken(t);
+
+        if(_self != nullptr &&
+           _self->mailed.load(std::memory_order_acquire) != 0) {
+          std::lock_guard<std::mutex> lock(_self->mailbox_mutex);
+          t = _self->mailbox.front();
+          _self->mailbox.pop_front();
+          _self->mailed.fetch_sub(1, std::memory_order_relaxed);
+          return t;
+        }
+
+        if(m_queued.load(std::memory_order_acquire) == 0)
+          return nullptr;
+
+        {
+          std::lock_guard<std::mutex> lock(m_inject_mutex);
+          if(!m_inject.empty()) {
+            t = m_inject.front();
+            m_inject.pop_front();
+            return taken(t);
+          }
+        }
+
+        size_t n = m_workers.size();
+        size_t start = (_self != nullptr) ? _self->id + 1 : 0;
+        for(size_t i = 0; i < n; ++i) {
+          worker* victim = m_workers[(start + i) % n];
+          if(victim != _self && victim->tasks.steal(t))
+            return taken(t);
+        }
+        return nullptr;
+      }
+
+      task* taken(task* _t) {
+        m_queued.fetch_sub(1, std::memory_order_relaxed);
+        return _t;
+      }
+
+      inline void execute(task* _task);
+
+      void worker_loop(size_t _id) {
+        worker* self = m_workers[_id];
+        current() = self;
+        if(m_pinned)
+          pin(self->cpu);
+
+        while(true) {
+          task* t = acquire(self);
+          if(t != nullptr) {
+            execute(t);
+            continue;
+          }
+
+          std::unique_lock<std::mutex> lock(m_mutex);
+          if(m_stop)
+            break;
+          m_idle.fetch_add(1, std::memory_order_seq_cst);
+          m_sleep.wait(lock, [this, self] {
+            return m_stop ||
+                   m_queued.load(std::memory_order_seq_cst) > 0 ||
+                   self->mailed.load(std::memory_order_acquire) > 0;
+          });
+          m_idle.fetch_sub(1, std::memory_order_relaxed);
+        }
+        current() = nullptr;
+      }
+
+      void pin(int _cpu) {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(_cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)_cpu;
+#endif
+      }
+
+      std::vector<worker*> m_workers;
+      std::vector<std::vector<size_t>> m_node_workers;
+      bool m_pinned{false};
+
+      std::mutex m_inject_mutex;
+      std::deque<task*> m_inject;          // tasks from outside the pool
+      std::atomic<size_t> m_queued{0};     // tasks waiting in any queue
+
+      std::mutex m_mutex;
+      std::condition_variable m_sleep;
+      std::atomic<size_t> m_idle{0};
+      bool m_stop{false};
+  };
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief Fork-join scope. Tasks forked with run() may fork further tasks
+  ///        of their own; wait() returns once every forked task finished.
+  ///        The waiting thread executes pending tasks rather than blocking,
+  ///        so nested groups do not deadlock the pool.
+  ///
+  ///        With a null executor run() executes the task immediately.
+  ///
+  ///        A task that throws still counts as finished; the first
+  ///        exception is rethrown by wait(). The destructor joins without
+  ///        rethrowing.
+  /////////////////////////////////////////////////////////////////////////////
+  class task_group {
+    public:
+      /// @name constructors
+      /// @{
+      task_group(executor* _exec): m_exec(_exec) {}
+      ~task_group() { join(); }
+
+      task_group(const task_group&) = delete;
+      task_group& operator=(const task_group&) = delete;
+      /// @}
+
+      /// @name Fork-Join
+      /// @{
+      template<typename Func>
+      void run(Func _func) {
+        if(m_exec == nullptr) {
+          _func();
+          return;
+        }
+        m_pending.fetch_add(1, std::memory_order_relaxed);
+        m_exec->submit(new executor::task{std::function<void()>(_func), this});
+      }
+
+      /// @brief Forks a task that only worker _worker may execute.
+      template<typename Func>
+      void run_on(size_t _worker, Func _func) {
+        if(m_exec == nullptr) {
+          _func();
+          return;
+        }
+        m_pending.fetch_add(1, std::memory_order_relaxed);
+        m_exec->submit_to(_worker,
+                          new executor::task{std::function<void()>(_func), this});
+      }
+
+      /// @brief Forks a task onto the workers of _node, round robin. When
+      ///        no worker is pinned to _node the task may run anywhere.
+      template<typename Func>
+      void run_on_node(size_t _node, Func _func) {
+        if(m_exec == nullptr || _node >= m_exec->num_nodes() ||
+           m_exec->node_workers(_node).empty()) {
+          run(_func);
+          return;
+        }
+        const std::vector<size_t>& workers = m_exec->node_workers(_node);
+        size_t next = m_next_worker.fetch_add(1, std::memory_order_relaxed);
+        run_on(workers[next % workers.size()], _func);
+      }
+
+      void wait() {
+        join();
+        if(m_error) {
+          std::exception_ptr error = m_error;
+          m_error = nullptr;
+          std::rethrow_exception(error);
+        }
+      }
+      /// @}
+
+    private:
+      friend class executor;
+
+      void join() {
+        if(m_exec == nullptr)
+          return;
+        executor::worker* self = executor::current();
+        if(self != nullptr && self->owner != m_exec)
+          self = nullptr;
+
+        while(m_pending.load(std::memory_order_acquire) != 0) {
+          executor::task* t = m_exec->acquire(self);
+          if(t != nullptr)
+            m_exec->execute(t);
+          else
+            std::this_thread::yield();
+        }
+      }
+
+      void fail(std::exception_ptr _error) {
+        std::lock_guard<std::mutex> lock(m_error_mutex);
+        if(!m_error)
+          m_error = _error;
+      }
+
+      void done() { m_pending.fetch_sub(1, std::memory_order_acq_rel); }
+
+      executor* m_exec;
+      std::atomic<size_t> m_pending{0};
+      std::atomic<size_t> m_next_worker{0};  // round robin for run_on_node
+      std::mutex m_error_mutex;
+      std::exception_ptr m_error;            // first exception of a task
+  };
+
+  inline void executor::execute(task* _task) {
+    task_group* group = _task->group;
+    try {
+      _task->func();
+    }
+    catch(...) {
+      group->fail(std::current_exception());
+    }
+    delete _task;
+    group->done();
+  }
+
+  template<typename Func>
+  void executor::parallel_for(size_t _begin, size_t _end, Func _func,
+                              size_t _grain, Schedule _sched) {
+    if(_begin >= _end)
+      return;
+
+    size_t count = _end - _begin;
+    size_t threads = num_threads() + 1;     // the caller works too
+    if(_grain == 0)
+      _grain = std::max<size_t>(1, count / (threads * 8));
+
+    if(count <= _grain) {
+      for(size_t i = _begin; i < _end; ++i)
+        _func(i);
+      return;
+    }
+
+    task_group group(this);
+
+    if(_sched == STATIC) {
+      size_t chunks = std::min(threads, (count + _grain - 1) / _grain);
+      size_t step = (count + chunks - 1) / chunks;
+      for(size_t c = 1; c < chunks; ++c) {
+        size_t lo = _begin + c * step;
+        size_t hi = std::min(_end, lo + step);
+        group.run([lo, hi, &_func] {
+          for(size_t i = lo; i < hi; ++i)
+            _func(i);
+        });
+      }
+      for(size_t i = _begin; i < std::min(_end, _begin + step); ++i)
+        _func(i);
+      group.wait();
+      return;
+    }
+
+    std::atomic<size_t> next{_begin};
+    auto claim = [&](size_t& _lo, size_t& _hi) {
+      size_t lo = next.load(std::memory_order_relaxed);
+      while(lo < _end) {
+        size_t size = _grain;
+        if(_sched == GUIDED)
+          size = std::max(_grain, (_end - lo) / (2 * threads));
+        size_t hi = std::min(_end, lo + size);
+        if(next.compare_exchange_weak(lo, hi, std::memory_order_relaxed)) {
+          _lo = lo;
+          _hi = hi;
+          return true;
+        }
+      }
+      return false;
+    };
+    auto body = [&] {
+      size_t lo, hi;
+      while(claim(lo, hi))
+        for(size_t i = lo; i < hi; ++i)
+          _func(i);
+    };
+
+    for(size_t t = 1; t < threads; ++t)
+      group.run(body);
+    body();
+    group.wait();
+  }
+
+  /// @brief Runs the loop on _exec, or serially on the calling thread when
+  ///        _exec is null.
+  template<typename Func>
+  void parallel_for(executor* _exec, size_t _begin, size_t _end, Func _func,
+                    size_t _grain = 0, Schedule _sched = STATIC) {
+    if(_exec == nullptr) {
+      for(size_t i = _begin; i < _end; ++i)
+        _func(i);
+    }
+    else
+      _exec->parallel_for(_begin, _end, _func, _grain, _sched);
+  }
+
+  /// @brief Merge sort forking the halves onto _exec down to _grain
+  ///        elements, which are sorted with std::sort. Not stable; serial
+  ///        when _exec is null.
+  template<typename Iter, typename Compare>
+  void parallel_sort(executor* _exec, Iter _begin, Iter _end, Compare _comp,
+                     size_t _grain = 4096) {
+    size_t n = _end - _begin;
+    if(_exec == nullptr || n <= _grain) {
+      std::sort(_begin, _end, _comp);
+      return;
+    }
+    Iter middle = _begin + n / 2;
+    task_group group(_exec);
+    group.run([&] { parallel_sort(_exec, _begin, middle, _comp, _grain); });
+    parallel_sort(_exec, middle, _end, _comp, _grain);
+    group.wait();
+    std::inplace_merge(_begin, middle, _end, _comp);
+  }
+}
+
+#endif // EXECUTOR_H
@@ -0,0 +1,192 @@
+#include "executor.h"
+#include "union_find.h"
+#include "../Test/unit_test.h"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include <cassert>
+
+using nostd::executor;
+using nostd::task_group;
+
+class executor_test : public test_class {
+
+  void test() {
+    deque_push_pop();
+    loop_schedules();
+    fork_join();
+    exceptions();
+    serial_fallback();
+    node_affinity();
+    sorting();
+    disjoint_sets();
+  }
+
+  void benchmarks() {
+    executor exec(4);
+    std::vector<double> values(1 << 16, 1.0);
+
+    benchmark("parallel_for static", [&] {
+      exec.parallel_for(0, values.size(), [&](size_t i) { values[i] *= 1.0000001; },
+                        1024, nostd::STATIC);
+    });
+    benchmark("parallel_for dynamic", [&] {
+      exec.parallel_for(0, values.size(), [&](size_t i) { values[i] *= 1.0000001; },
+                        1024, nostd::DYNAMIC);
+    });
+    do_not_optimize(values.data());
+
+    benchmark("task_group fib(18)", [&] { do_not_optimize(fib(&exec, 18)); });
+
+    std::vector<int> keys, sorted;
+    for(int i = 0; i < 100000; ++i)
+      keys.push_back((i * 7919) % 100003);
+    benchmark("parallel_sort", [&] {
+      sorted = keys;
+      nostd::parallel_sort(&exec, sorted.begin(), sorted.end(), std::less<int>());
+    });
+
+    nostd::union_find sets(keys.size());
+    benchmark("union_find", [&] {
+      sets.reset(keys.size());
+      exec.parallel_for(0, keys.size() - 1, [&](size_t i) {
+        sets.unite(uint32_t(keys[i] % keys.size()), uint32_t(i));
+      }, 1024);
+    });
+  }
+
+
+  void deque_push_pop() {
+    nostd::work_deque<int> d(2);
+    for(int i = 0; i < 100; ++i)
+      d.push(i);
+
+    int x = -1;
+    assert(d.pop(x) && x == 99);
+    assert(d.steal(x) && x == 0);
+  }
+
+  void loop_schedules() {
+    executor exec(4);
+    nostd::Schedule scheds[] = {nostd::STATIC, nostd::DYNAMIC, nostd::GUIDED};
+
+    for(auto s : scheds) {
+      std::vector<std::atomic<int>> hits(10000);
+      exec.parallel_for(0, hits.size(), [&](size_t i) { ++hits[i]; }, 16, s);
+
+      bool once = true;
+      for(auto& h : hits)
+        once = once && h == 1;
+      assert(once);
+    }
+  }
+
+  size_t fib(executor* _exec, size_t _n) {
+    if(_n < 2)
+      return _n;
+    size_t a = 0, b = 0;
+    task_group group(_exec);
+    group.run([&] { a = fib(_exec, _n - 1); });
+    b = fib(_exec, _n - 2);
+    group.wait();
+    return a + b;
+  }
+
+  void fork_join() {
+    executor exec(3, true);
+    assert(fib(&exec, 18) == 2584);
+  }
+
+  // a throwing task still finishes; wait() rethrows and the pool goes on
+  void exceptions() {
+    executor exec(3);
+    std::atomic<int> ran{0};
+    bool caught = false;
+    try {
+      task_group group(&exec);
+      for(int i = 0; i < 16; ++i)
+        group.run([&, i] {
+          ++ran;
+          if(i % 4 == 0)
+            throw std::runtime_error("task");
+        });
+      group.wait();
+    }
+    catch(const std::runtime_error&) {
+      caught = true;
+    }
+    assert(caught && ran == 16);
+
+    caught = false;
+    try {
+      exec.parallel_for(0, 1000, [](size_t i) {
+        if(i == 999)
+          throw std::runtime_error("loop");
+      }, 10, nostd::DYNAMIC);
+    }
+    catch(const std::runtime_error&) {
+      caught = true;
+    }
+    assert(caught && fib(&exec, 12) == 144);
+  }
+
+  void serial_fallback() {
+    size_t sum = 0;
+    nostd::parallel_for(nullptr, 0, 10, [&](size_t i) { sum += i; });
+    assert(sum == 45 && fib(nullptr, 10) == 55);
+  }
+
+  void node_affinity() {
+    nostd::numa_topology topo({{0}, {0}});
+    executor exec(4, true, topo);
+    assert(exec.num_nodes() == 2 && exec.node_workers(1).size() == 2);
+
+    // memory only OS nodes 0 and 2 are dropped but the OS ids are kept
+    nostd::numa_topology sparse({{}, {0}, {}, {1}});
+    assert(sparse.num_nodes() == 2 && sparse.os_node(0) == 1 && sparse.os_node(1) == 3);
+    assert(sparse.node_of_cpu(1) == 1 && nostd::numa_topology::system().num_nodes() >= 1);
+
+    std::atomic<int> misplaced{0};
+    task_group group(&exec);
+    for(int i = 0; i < 32; ++i)
+      group.run_on_node(1, [&] {
+        if(exec.worker_id() % 2 != 1)
+          ++misplaced;
+      });
+    group.wait();
+    assert(misplaced == 0);
+  }
+
+  void sorting() {
+    executor exec(4);
+    std::vector<int> v;
+    for(int i = 0; i < 100000; ++i)
+      v.push_back((i * 7919) % 100003);
+    std::vector<int> expected = v;
+    std::sort(expected.begin(), expected.end());
+    nostd::parallel_sort(&exec, v.begin(), v.end(), std::less<int>(), 1000);
+    assert(v == expected);
+  }
+
+  void disjoint_sets() {
+    executor exec(4);
+    const size_t n = 10000;
+    nostd::union_find sets(n);
+
+    // odd and even chains, united from many tasks at once
+    std::atomic<size_t> merged{0};
+    exec.parallel_for(0, n - 2, [&](size_t i) {
+      if(sets.unite(uint32_t(i), uint32_t(i + 2)))
+        ++merged;
+    }, 16, nostd::DYNAMIC);
+    assert(merged == n - 2);
+    assert(sets.same(0, n - 2) && sets.same(1, n - 1) && !sets.same(0, 1));
+    assert(!sets.unite(4, 8) && sets.unite(0, 1) && sets.find(n - 1) == 0);
+  }
+
+};
+
+int main(int argc, char** argv) {
+  executor_test etest;
+  return run_suite(etest, argc, argv);
+}
@@ -0,0 +1,270 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @name NUMA Topology
+/// @group Parallel
+///
+/// @note Topology discovery and node local allocation.
+///
+///       With NOSTD_HAVE_LIBNUMA defined (and -lnuma) libnuma is used for
+///       both. Otherwise the topology is read from sysfs and memory is
+///       mapped with mmap and bound to its node with the mbind system call.
+///       When neither is available everything degrades to a single node
+///       holding every cpu and plain heap memory.
+///
+///       Memory from numa_alloc is not touched by the allocator, so the
+///       pages also land on the node of the thread that first writes them.
+///
+///       Nodes without cpus (memory only nodes such as CXL or HBM) are
+///       dropped and the rest numbered 0, 1, ... in OS id order. The OS id
+///       of each such logical node is kept in os_node(); numa_alloc and
+///       numa_array take OS ids, since that is what the kernel binds to.
+///
+///////////////////////////////////////////////////////////////////////////////
+#ifndef NUMA_TOPOLOGY_H
+#define NUMA_TOPOLOGY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef NOSTD_HAVE_LIBNUMA
+#include <numa.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace nostd {
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief The nodes of the machine and the cpus that belong to them.
+  /////////////////////////////////////////////////////////////////////////////
+  class numa_topology {
+    public:
+      /// @name constructors
+      /// @{
+
+      /// @brief A single node holding _cpus cpus.
+      numa_topology(size_t _cpus) {
+        m_cpus.resize(1);
+        m_os_node.push_back(0);
+        for(size_t i = 0; i < _cpus; ++i)
+          m_cpus[0].push_back(int(i));
+      }
+
+      /// @brief Nodes holding the given cpus; element i is OS node i.
+      numa_topology(const std::vector<std::vector<int>>& _cpus): m_cpus(_cpus) {
+        prune();
+      }
+
+      /// @brief Topology of the running machine, discovered once.
+      static const numa_topology& system() {
+        static numa_topology topo = discover();
+        return topo;
+      }
+      /// @}
+
+      /// @name Topology Access
+      /// @{
+      size_t num_nodes() const { return m_cpus.size(); }
+
+      const std::vector<int>& cpus(size_t _node) const { return m_cpus[_node]; }
+
+      /// @return The OS id of logical node _node
+      size_t os_node(size_t _node) const { return m_os_node[_node]; }
+
+      size_t node_of_cpu(int _cpu) const {
+        for(size_t n = 0; n < m_cpus.size(); ++n)
+          for(auto c : m_cpus[n])
+            if(c == _cpu)
+              return n;
+        return 0;
+      }
+      /// @}
+
+    private:
+      numa_topology() {}
+
+      static numa_topology discover() {
+        numa_topology topo;
+#ifdef NOSTD_HAVE_LIBNUMA
+        if(numa_available() >= 0) {
+          int nodes = numa_max_node() + 1;
+          int cpus = numa_num_configured_cpus();
+          topo.m_cpus.resize(nodes);
+          for(int c = 0; c < cpus; ++c) {
+            int n = numa_node_of_cpu(c);
+            if(n >= 0)
+              topo.m_cpus[n].push_back(c);
+          }
+        }
+#else
+        // node ids need not be contiguous, so read which are online
+        std::vector<int> online;
+        if(FILE* file = fopen("/sys/devices/system/node/online", "r")) {
+          online = parse_cpulist(file);
+          fclose(file);
+        }
+        for(int n : online) {
+          char path[64];
+          snprintf(path, sizeof(path),
+                   "/sys/devices/system/node/node%d/cpulist", n);
+          FILE* file = fopen(path, "r");
+          if(file == nullptr)
+            continue;
+          if(size_t(n) >= topo.m_cpus.size())
+            topo.m_cpus.resize(n + 1);
+          topo.m_cpus[n] = parse_cpulist(file);
+          fclose(file);
+        }
+#endif
+        topo.prune();
+        if(topo.m_cpus.empty())
+          return numa_topology(std::max(1u, std::thread::hardware_concurrency()));
+        return topo;
+      }
+
+      // cpulist and online files look like "0-7,16-23"
+      static std::vector<int> parse_cpulist(FILE* _file) {
+        std::vector<int> cpus;
+        int lo, hi;
+        while(fscanf(_file, "%d", &lo) == 1) {
+          hi = lo;
+          int c = fgetc(_file);
+          if(c == '-') {
+            if(fscanf(_file, "%d", &hi) != 1)
+              break;
+            c = fgetc(_file);
+          }
+          for(int i = lo; i <= hi; ++i)
+            cpus.push_back(i);
+          if(c != ',')
+            break;
+        }
+        return cpus;
+      }
+
+      // memory only nodes have no cpus to run on; m_cpus is indexed by OS
+      // id before and by logical node after
+      void prune() {
+        std::vector<std::vector<int>> nodes;
+        m_os_node.clear();
+        for(size_t n = 0; n < m_cpus.size(); ++n)
+          if(!m_cpus[n].empty()) {
+            nodes.push_back(m_cpus[n]);
+            m_os_node.push_back(n);
+          }
+        m_cpus.swap(nodes);
+      }
+
+      std::vector<std::vector<int>> m_cpus;   // cpus of each node
+      std::vector<size_t> m_os_node;          // OS id of each node
+  };
+
+  /// @brief Allocates _bytes of memory preferring OS node _node. The memory
+  ///        is uninitialized and must be released with numa_free.
+  inline void* numa_alloc(size_t _bytes, size_t _node) {
+    if(_bytes == 0)
+      return nullptr;
+#ifdef NOSTD_HAVE_LIBNUMA
+    if(numa_available() >= 0 && int(_node) <= numa_max_node())
+      return numa_alloc_onnode(_bytes, int(_node));
+    return malloc(_bytes);
+#elif defined(__linux__) && defined(SYS_mbind)
+    void* mem = mmap(nullptr, _bytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(mem == MAP_FAILED)
+      return nullptr;
+    if(_node < 8 * sizeof(unsigned long)) {
+      const int preferred = 1;          // MPOL_PREFERRED
+      unsigned long mask = 1ul << _node;
+      // a failure leaves the default first touch policy in place
+      syscall(SYS_mbind, mem, _bytes, preferred, &mask,
+              8 * sizeof(unsigned long), 0);
+    }
+    return mem;
+#else
+    (void)_node;
+    return malloc(_bytes);
+#endif
+  }
+
+  /// @brief Releases memory from numa_alloc(_bytes, _node).
+  inline void numa_free(void* _mem, size_t _bytes, size_t _node) {
+    if(_mem == nullptr)
+      return;
+#ifdef NOSTD_HAVE_LIBNUMA
+    if(numa_available() >= 0 && int(_node) <= numa_max_node()) {
+      ::numa_free(_mem, _bytes);
+      return;
+    }
+    free(_mem);
+#elif defined(__linux__) && defined(SYS_mbind)
+    (void)_node;
+    munmap(_mem, _bytes);
+#else
+    (void)_bytes;
+    (void)_node;
+    free(_mem);
+#endif
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  /// @brief Fixed size array of trivially copyable T living on one OS node.
+  ///        The elements are left uninitialized so the owning node's
+  ///        threads can first touch them.
+  /////////////////////////////////////////////////////////////////////////////
+  template<typename T>
+  class numa_array {
+    public:
+      /// @name constructors
+      /// @{
+      numa_array(size_t _size = 0, size_t _node = 0): m_size(_size),
+                                                       m_node(_node) {
+        m_data = static_cast<T*>(numa_alloc(m_size * sizeof(T), m_node));
+      }
+
+      ~numa_array() { numa_free(m_data, m_size * sizeof(T), m_node); }
+
+      numa_array(const numa_array&) = delete;
+      numa_array& operator=(const numa_array&) = delete;
+
+      numa_array(numa_array&& _other): m_data(_other.m_data),
+                                       m_size(_other.m_size),
+                                       m_node(_other.m_node) {
+        _other.m_data = nullptr;
+        _other.m_size = 0;
+      }
+
+      numa_array& operator=(numa_array&& _other) {
+        std::swap(m_data, _other.m_data);
+        std::swap(m_size, _other.m_size);
+        std::swap(m_node, _other.m_node);
+        return *this;
+      }
+      /// @}
+
+      /// @name Element Access
+      /// @{
+      T& operator[](size_t _i) { return m_data[_i]; }
+      const T& operator[](size_t _i) const { return m_data[_i]; }
+
+      T* data() { return m_data; }
+      const T* data() const { return m_data; }
+
+      size_t size() const { return m_size; }
+      size_t node() const { return m_node; }
+      /// @}
+
+    private:
+      T* m_data;
+      size_t m_size;
+      size_t m_node;
+  };
+}
+
+#endif // NUMA_TOPOLOGY_H
@@ -0,0 +1,117 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @name Union Find
+/// @group Parallel
+///
+/// @note Disjoint sets over the elements [0, size()) that any number of
+///       threads may find and unite at once, without locks.
+///
+///       Parents are atomics. A root is only ever linked with a compare and
+///       swap of its own parent, and the larger root is hung under the
+///       smaller one, so the sets stay acyclic. find() halves the path it
+///       walks; halving only moves a parent pointer to an ancestor, so a
+///       failed or stale halving is harmless.
+///
+///       same() and find() are exact once the concurrent unites are done;
+///       while they are running an answer may already be out of date.
+///
+///       grow() appends singleton elements, doubling the storage when it
+///       runs out, so sets can follow a growing graph. It must not run
+///       concurrently with anything else.
+///
+///////////////////////////////////////////////////////////////////////////////
+#ifndef UNION_FIND_H
+#define UNION_FIND_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace nostd {
+
+  class union_find {
+    public:
+      /// @name constructors
+      /// @{
+      union_find(size_t _size = 0) { reset(_size); }
+      /// @}
+
+      size_t size() const { return m_size; }
+
+      /// @brief Puts every element back in its own set
+      void reset(size_t _size) {
+        if(_size > m_capacity) {
+          m_parent.reset(new std::atomic<uint32_t>[_size]);
+          m_capacity = _size;
+        }
+        m_size = _size;
+        for(size_t i = 0; i < m_size; ++i)
+          m_parent[i].store(uint32_t(i), std::memory_order_relaxed);
+      }
+
+      /// @brief Adds elements up to _size, each in its own set
+      void grow(size_t _size) {
+        if(_size > m_capacity) {
+          size_t capacity = std::max(_size, 2 * m_capacity);
+          std::unique_ptr<std::atomic<uint32_t>[]> parent(new std::atomic<uint32_t>[capacity]);
+          for(size_t i = 0; i < m_size; ++i)
+            parent[i].store(m_parent[i].load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+          m_parent.swap(parent);
+          m_capacity = capacity;
+        }
+        for(size_t i = m_size; i < _size; ++i)
+          m_parent[i].store(uint32_t(i), std::memory_order_relaxed);
+        m_size = std::max(m_size, _size);
+      }
+
+      /// @return Representative of the set holding _x
+      uint32_t find(uint32_t _x) {
+        while(true) {
+          uint32_t parent = m_parent[_x].load(std::memory_order_relaxed);
+          if(parent == _x)
+            return _x;
+          uint32_t grand = m_parent[parent].load(std::memory_order_relaxed);
+          if(grand != parent)
+            m_parent[_x].compare_exchange_weak(parent, grand, std::memory_order_relaxed);
+          _x = grand;
+        }
+      }
+
+      /// @brief Merges the sets of _a and _b
+      /// @return Whether they were separate, i.e. this call merged them
+      bool unite(uint32_t _a, uint32_t _b) {
+        while(true) {
+          _a = find(_a);
+          _b = find(_b);
+          if(_a == _b)
+            return false;
+          if(_a < _b)
+            std::swap(_a, _b);
+          uint32_t expected = _a;
+          if(m_parent[_a].compare_exchange_strong(expected, _b))
+            return true;
+        }
+      }
+
+      bool same(uint32_t _a, uint32_t _b) {
+        while(true) {
+          _a = find(_a);
+          _b = find(_b);
+          if(_a == _b)
+            return true;
+          // _a may have been linked since it was found
+          if(m_parent[_a].load() == _a)
+            return false;
+        }
+      }
+
+    private:
+      std::unique_ptr<std::atomic<uint32_t>[]> m_parent;
+      size_t m_size{0};
+      size_t m_capacity{0};
+  };
+}
+
+#endif // UNION_FIND_H
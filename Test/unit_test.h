@@ -0,0 +1,442 @@
+///////////////////////////////////////////////////////////////////////////////
+/// @name Unit Test
+/// @group Testing
+///
+/// @note The test harness shared by every test suite. A suite derives from
+///       test_class, implements test() and, optionally, benchmarks():
+///
+///           int main(int argc, char** argv) {
+///             my_test t;
+///             return run_suite(t, argc, argv);
+///           }
+///
+///       runs the tests, or the benchmarks when given --bench. With
+///       --baseline FILE the median of every benchmark is compared to the
+///       one recorded in FILE and the run fails when it grows by more than
+///       --tolerance (default 1.0, i.e. doubles) in three runs of the
+///       benchmarks; --save-baseline FILE records the medians of this run. A baseline file holds one
+///       "median_ns name" line per benchmark. Benchmarks missing from it
+///       are reported but do not fail.
+///
+///       benchmark() times a function: it doubles the calls per sample
+///       until a sample takes min_sample_ns, runs warmup samples that are
+///       thrown away, then repetitions samples. The report is the median,
+///       99th percentile, mean and standard deviation of the time per call
+///       and the heap allocations per call.
+///
+///       Allocations are counted by replacing every global operator new
+///       and delete (plain, array, nothrow and aligned), so include this
+///       header in one translation unit per program, or define
+///       NOSTD_NO_ALLOCATION_HOOK before including it in the others.
+///       allocation_count() returns the running total.
+///
+///       do_not_optimize(x) keeps the compiler from dropping a computation
+///       whose result is otherwise unused; clobber_memory() forces pending
+///       stores out.
+///
+///////////////////////////////////////////////////////////////////////////////
+#ifndef _UNIT_TEST_H_
+#define _UNIT_TEST_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+/// @name Allocation Counting
+/// @{
+
+inline std::atomic<size_t>& allocation_counter() {
+  static std::atomic<size_t> count{0};
+  return count;
+}
+
+/// @return Heap allocations made through operator new so far
+inline size_t allocation_count() {
+  return allocation_counter().load(std::memory_order_relaxed);
+}
+
+#ifndef NOSTD_NO_ALLOCATION_HOOK
+// Every form allocates with malloc or aligned_alloc and releases with free.
+// They are not inlined, so the compiler does not pair malloc() with
+// operator delete or free() with operator new.
+
+/// @return Counted memory of _size bytes aligned to _align, or nullptr
+__attribute__((noinline)) inline void* counted_alloc(size_t _size, size_t _align) {
+  allocation_counter().fetch_add(1, std::memory_order_relaxed);
+  if(_size == 0)
+    _size = 1;
+  if(_align <= alignof(std::max_align_t))
+    return std::malloc(_size);
+  // aligned_alloc wants a multiple of the alignment
+  return std::aligned_alloc(_align, (_size + _align - 1) / _align * _align);
+}
+
+__attribute__((noinline)) inline void* counted_new(size_t _size, size_t _align) {
+  if(void* p = counted_alloc(_size, _align))
+    return p;
+  throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void* operator new(size_t _size) {
+  return counted_new(_size, 0);
+}
+__attribute__((noinline)) void* operator new[](size_t _size) {
+  return counted_new(_size, 0);
+}
+__attribute__((noinline)) void* operator new(size_t _size, const std::nothrow_t&) noexcept {
+  return counted_alloc(_size, 0);
+}
+__attribute__((noinline)) void* operator new[](size_t _size, const std::nothrow_t&) noexcept {
+  return counted_alloc(_size, 0);
+}
+__attribute__((noinline)) void* operator new(size_t _size, std::align_val_t _align) {
+  return counted_new(_size, size_t(_align));
+}
+__attribute__((noinline)) void* operator new[](size_t _size, std::align_val_t _align) {
+  return counted_new(_size, size_t(_align));
+}
+__attribute__((noinline)) void* operator new(size_t _size, std::align_val_t _align,
+                                             const std::nothrow_t&) noexcept {
+  return counted_alloc(_size, size_t(_align));
+}
+__attribute__((noinline)) void* operator new[](size_t _size, std::align_val_t _align,
+                                               const std::nothrow_t&) noexcept {
+  return counted_alloc(_size, size_t(_align));
+}
+
+__attribute__((noinline)) void operator delete(void* _p) noexcept { std::free(_p); }
+__attribute__((noinline)) void operator delete[](void* _p) noexcept { std::free(_p); }
+__attribute__((noinline)) void operator delete(void* _p, size_t) noexcept { std::free(_p); }
+__attribute__((noinline)) void operator delete[](void* _p, size_t) noexcept { std::free(_p); }
+__attribute__((noinline)) void operator delete(void* _p, const std::nothrow_t&) noexcept {
+  std::free(_p);
+}
+__attribute__((noinline)) void operator delete[](void* _p, const std::nothrow_t&) noexcept {
+  std::free(_p);
+}
+__attribute__((noinline)) void operator delete(void* _p, std::align_val_t) noexcept {
+  std::free(_p);
+}
+__attribute__((noinline)) void operator delete[](void* _p, std::align_val_t) noexcept {
+  std::free(_p);
+}
+__attribute__((noinline)) void operator delete(void* _p, size_t, std::align_val_t) noexcept {
+  std::free(_p);
+}
+__attribute__((noinline)) void operator delete[](void* _p, size_t, std::align_val_t) noexcept {
+  std::free(_p);
+}
+__attribute__((noinline)) void operator delete(void* _p, std::align_val_t,
+                                               const std::nothrow_t&) noexcept {
+  std::free(_p);
+}
+__attribute__((noinline)) void operator delete[](void* _p, std::align_val_t,
+                                                 const std::nothrow_t&) noexcept {
+  std::free(_p);
+}
+#endif
+/// @}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @name Optimization Barriers
+/// @{
+
+/// @brief Makes the compiler assume _value is read, so it is computed
+template<typename T>
+inline void do_not_optimize(const T& _value) {
+  asm volatile("" : : "r,m"(_value) : "memory");
+}
+
+/// @brief Makes the compiler assume all memory is read and written
+inline void clobber_memory() {
+  asm volatile("" : : : "memory");
+}
+/// @}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief How a benchmark is sampled
+////////////////////////////////////////////////////////////////////////////////
+struct benchmark_options {
+  size_t warmup{3};                     ///< Samples thrown away
+  size_t repetitions{25};               ///< Samples measured
+  uint64_t min_sample_ns{1000000};      ///< Calls are added up to this time
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Statistics of one benchmark; times are per call
+////////////////////////////////////////////////////////////////////////////////
+struct benchmark_result {
+  std::string name;
+  size_t calls{0};                      ///< Calls per sample
+  std::vector<double> samples;          ///< Nanoseconds per call, sorted
+  double median_ns{0};
+  double p99_ns{0};
+  double mean_ns{0};
+  double stddev_ns{0};
+  double allocations{0};                ///< Per call
+
+  /// @brief Fills the statistics from samples
+  void summarize() {
+    std::sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+    if(n == 0)
+      return;
+    median_ns = (n % 2 == 1) ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    // nearest rank
+    p99_ns = samples[size_t(std::ceil(0.99 * n)) - 1];
+    double sum = 0;
+    for(auto s : samples)
+      sum += s;
+    mean_ns = sum / n;
+    double squares = 0;
+    for(auto s : samples)
+      squares += (s - mean_ns) * (s - mean_ns);
+    stddev_ns = (n > 1) ? std::sqrt(squares / (n - 1)) : 0;
+  }
+};
+
+inline std::ostream& operator<<(std::ostream& _out, const benchmark_result& _r) {
+  std::ios::fmtflags flags = _out.flags();
+  std::streamsize precision = _out.precision();
+  _out << std::fixed << std::setprecision(1)
+       << _r.name << ": median_ns " << _r.median_ns
+       << " p99_ns " << _r.p99_ns
+       << " mean_ns " << _r.mean_ns
+       << " stddev_ns " << _r.stddev_ns
+       << std::setprecision(2) << " allocations " << _r.allocations
+       << " (" << _r.samples.size() << " x " << _r.calls << " calls)";
+  _out.flags(flags);
+  _out.precision(precision);
+  return _out;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Recorded benchmark medians, to catch slowdowns
+////////////////////////////////////////////////////////////////////////////////
+class benchmark_baseline {
+  public:
+    /// @return Read _path or not; a missing file leaves the baseline empty
+    bool load(const std::string& _path) {
+      std::ifstream in(_path);
+      if(!in)
+        return false;
+      double median;
+      std::string name;
+      while(in >> median && std::getline(in >> std::ws, name))
+        m_medians[name] = median;
+      return true;
+    }
+
+    /// @return Wrote the medians of _results to _path or not
+    static bool save(const std::string& _path,
+                     const std::vector<benchmark_result>& _results) {
+      std::ofstream out(_path);
+      out << std::fixed << std::setprecision(1);
+      for(auto& r : _results)
+        out << r.median_ns << " " << r.name << "\n";
+      return bool(out);
+    }
+
+    /// @brief Reports every result against its recorded median
+    /// @return No median grew by more than _tolerance, a fraction
+    bool check(const std::vector<benchmark_result>& _results, double _tolerance,
+               std::ostream& _out) const {
+      bool passed = true;
+      std::ios::fmtflags flags = _out.flags();
+      std::streamsize precision = _out.precision();
+      _out << std::fixed << std::setprecision(2);
+      for(auto& r : _results) {
+        auto iter = m_medians.find(r.name);
+        if(iter == m_medians.end()) {
+          _out << r.name << ": no baseline\n";
+          continue;
+        }
+        double ratio = r.median_ns / iter->second;
+        bool slower = ratio > 1 + _tolerance;
+        _out << r.name << ": " << ratio << "x baseline"
+             << (slower ? " REGRESSION" : "") << "\n";
+        passed = passed && !slower;
+      }
+      _out.flags(flags);
+      _out.precision(precision);
+      return passed;
+    }
+
+  private:
+    std::map<std::string, double> m_medians;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Test class for unit test framework
+/// @ingroup Testing
+////////////////////////////////////////////////////////////////////////////////
+class test_class {
+  public:
+    /// @brief Constructor
+    test_class() {}
+    /// @brief Destructor
+    virtual ~test_class() {}
+    /// @brief Run Unit test's setup, test, and teardown functions
+    /// @return Passed test or not
+    bool run() {
+      setup();
+      test();
+      tear_down();
+      return all_tests_passed();
+    }
+
+    /// @brief Run the benchmarks between setup and teardown, printing one
+    ///        line per benchmark to _out
+    /// @return Passed every check made by the benchmarks or not
+    bool run_benchmarks(std::ostream& _out = std::cout) {
+      m_out = &_out;
+      m_results.clear();
+      setup();
+      benchmarks();
+      tear_down();
+      return all_tests_passed();
+    }
+
+    /// @return Every benchmark of the last run_benchmarks()
+    const std::vector<benchmark_result>& results() const { return m_results; }
+
+  protected:
+    /// @brief Setup data to be tested
+    virtual void setup() {};
+    /// @brief Test data
+    virtual void test() = 0;
+    /// @brief Benchmarks, each a call to benchmark()
+    virtual void benchmarks() {};
+    /// @brief Teardown data which was tested
+    virtual void tear_down() {};
+
+    /// @return All asserts have passed
+    bool all_tests_passed() const {return !fail;}
+
+    /// @brief Assert a unit test passes
+    /// @param b Conditional for assert
+    /// @param msg Message on fail
+    void assert_msg(bool b, std::string msg) {
+      if(!b) {
+        std::cerr << msg << std::endl;
+        fail = true;
+      }
+    }
+
+    /// @brief Times _func; see the notes at the top of this file
+    /// @return The statistics, also printed and kept in results()
+    template<typename Func>
+    const benchmark_result& benchmark(const std::string& _name, Func _func,
+                                      benchmark_options _options = benchmark_options()) {
+      benchmark_result result;
+      result.name = _name;
+      result.calls = 1;
+      while(sample(_func, result.calls) < _options.min_sample_ns &&
+            result.calls < (size_t(1) << 30))
+        result.calls *= 2;
+      for(size_t i = 0; i < _options.warmup; ++i)
+        sample(_func, result.calls);
+
+      result.samples.reserve(_options.repetitions);
+      size_t before = allocation_count();
+      for(size_t i = 0; i < _options.repetitions; ++i)
+        result.samples.push_back(double(sample(_func, result.calls)) / result.calls);
+      result.allocations = double(allocation_count() - before) /
+                           (double(_options.repetitions) * result.calls);
+      result.summarize();
+
+      *m_out << result << std::endl;
+      m_results.push_back(result);
+      return m_results.back();
+    }
+
+  private:
+    template<typename Func>
+    static uint64_t sample(Func& _func, size_t _calls) {
+      auto start = std::chrono::steady_clock::now();
+      for(size_t i = 0; i < _calls; ++i) {
+        _func();
+        clobber_memory();
+      }
+      auto stop = std::chrono::steady_clock::now();
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+    }
+
+    bool fail = false; ///< Stores if any test case has failed
+    std::ostream* m_out{&std::cout};
+    std::vector<benchmark_result> m_results;
+};
+
+/// @brief Runs _test, or its benchmarks when the first argument is --bench;
+///        see the notes at the top of this file for the other arguments
+/// @return Exit code of the suite
+inline int run_suite(test_class& _test, int _argc, char** _argv) {
+  if(_argc > 1 && std::string(_argv[1]) == "--bench") {
+    std::string baseline, save;
+    double tolerance = 1.0;
+    for(int i = 2; i + 1 < _argc; i += 2) {
+      std::string flag = _argv[i];
+      if(flag == "--baseline")
+        baseline = _argv[i + 1];
+      else if(flag == "--save-baseline")
+        save = _argv[i + 1];
+      else if(flag == "--tolerance")
+        tolerance = std::atof(_argv[i + 1]);
+      else {
+        std::cerr << "unknown argument " << flag << std::endl;
+        return 1;
+      }
+    }
+
+    benchmark_baseline recorded;
+    bool checked = !baseline.empty() && recorded.load(baseline);
+    if(!baseline.empty() && !checked)
+      std::cout << "no baseline at " << baseline << "\n";
+
+    // a check that fails is run again, up to three runs, keeping the fastest
+    // median of each benchmark: a slowdown shows in every run, noise rarely
+    std::vector<benchmark_result> fastest;
+    for(size_t run = 1; ; ++run) {
+      if(!_test.run_benchmarks())
+        return 1;
+      const std::vector<benchmark_result>& results = _test.results();
+      if(fastest.size() != results.size())
+        fastest = results;
+      for(size_t i = 0; i < results.size(); ++i)
+        if(results[i].name == fastest[i].name &&
+           results[i].median_ns < fastest[i].median_ns)
+          fastest[i] = results[i];
+
+      if(!checked || recorded.check(fastest, tolerance, std::cout))
+        break;
+      if(run == 3)
+        return 1;
+      std::cout << "running the benchmarks again\n";
+    }
+
+    if(!save.empty() && !benchmark_baseline::save(save, fastest)) {
+      std::cerr << "can not write " << save << std::endl;
+      return 1;
+    }
+    std::cout << "Benchmarks Successful\n";
+    return 0;
+  }
+  if(!_test.run())
+    return 1;
+  std::cout << "Test Successful\n";
+  return 0;
+}
+
+#endif
@@ -3,12 +3,19 @@
 /// @group Tree 
 ///
 /// @note Generic binary tree implementation with no ordering of the nodes.
-///       
+///
+///       The traversals take an optional executor; with one the left and
+///       right subtrees near the root are visited in parallel and the
+///       visit function may be called concurrently.
 ///
 ///////////////////////////////////////////////////////////////////////////////
 #ifndef BASE_TREE_H
 #define BASE_TREE_H
 
+#include <cstddef>
+
+#include "../Parallel/executor.h"
+
 namespace nostd {
   
   template<typename NodeType> 
@@ -26,6 +33,12 @@ namespace nostd {
         m_root = new tree_node(NodeType());
         m_root->m_right = new tree_node(NodeType());
       }
+
+      // the nodes are owned, so a tree is not copied
+      base_tree(const base_tree&) = delete;
+      base_tree& operator=(const base_tree&) = delete;
+
+      ~base_tree() { release(m_root); }
       
       
       iterator add(tree_node* _parent, const NodeType& _data) {
@@ -61,6 +74,26 @@ namespace nostd {
       
       iterator begin() { return iterator(m_root->m_left); } 
       iterator end() { return iterator(m_root->m_right); }
+
+      /// @name Traversals
+      /// @{
+
+      /// @brief Calls _visit(data) on every node, parents before children.
+      template<typename Visit>
+      void preorder(Visit _visit, executor* _exec = nullptr) {
+        traverse(m_root->m_left, _visit, _exec, spawn_depth(_exec), true);
+      }
+
+      /// @brief Calls _visit(data) on every node, children before parents.
+      template<typename Visit>
+      void postorder(Visit _visit, executor* _exec = nullptr) {
+        traverse(m_root->m_left, _visit, _exec, spawn_depth(_exec), false);
+      }
+
+      /// @}
+
+      tree_node* root() { return m_root; }
+      size_t size() const { return m_count; }
       
       
       class tree_node {
@@ -69,7 +102,7 @@ namespace nostd {
                     tree_node* _left = nullptr, 
                     tree_node* _right = nullptr):
                     m_data(_data), m_left(_left),
-                    m_right(_right) {}
+                    m_right(_right), m_parent(nullptr) {}
 
           void set_parent(tree_node* _p) { m_parent = _p; }
           
@@ -87,6 +120,9 @@ namespace nostd {
           tree_node* right() { return m_right; } 
           tree_node* parent() { return m_parent; }
 
+          NodeType& data() { return m_data; }
+          const NodeType& data() const { return m_data; }
+
         private:
           NodeType m_data;
 
@@ -102,6 +138,8 @@ namespace nostd {
         public:
           iterator(tree_node* _node): m_n(_node) {}
 
+          tree_node* node() { return m_n; }
+
           iterator operator++ () {}
           iterator operator++ (int) {}
 
@@ -113,8 +151,53 @@ namespace nostd {
       };
 
     private:
+      // forks the traversal of the left subtree for the first _depth levels
+      template<typename Visit>
+      void traverse(tree_node* _node, Visit& _visit, executor* _exec,
+                    size_t _depth, bool _pre) {
+        if(_node == nullptr)
+          return;
+        if(_pre)
+          _visit(_node->m_data);
+
+        if(_exec != nullptr && _depth > 0) {
+          task_group group(_exec);
+          group.run([&] {
+            traverse(_node->m_left, _visit, _exec, _depth - 1, _pre);
+          });
+          traverse(_node->m_right, _visit, _exec, _depth - 1, _pre);
+          group.wait();
+        }
+        else {
+          traverse(_node->m_left, _visit, nullptr, 0, _pre);
+          traverse(_node->m_right, _visit, nullptr, 0, _pre);
+        }
+
+        if(!_pre)
+          _visit(_node->m_data);
+      }
+
+      // deletes _node and its subtrees, children before parents
+      static void release(tree_node* _node) {
+        if(_node == nullptr)
+          return;
+        release(_node->m_left);
+        release(_node->m_right);
+        delete _node;
+      }
+
+      // enough forked subtrees to keep every worker busy
+      static size_t spawn_depth(executor* _exec) {
+        if(_exec == nullptr)
+          return 0;
+        size_t depth = 2;
+        for(size_t n = _exec->num_threads(); n > 0; n /= 2)
+          ++depth;
+        return depth;
+      }
+
       tree_node* m_root{nullptr}; //< a super root
-      size_t counter{}; //< why not?
+      size_t m_count{}; //< why not?
   };
 }
 
@@ -0,0 +1,124 @@
+#include "base_tree.h"
+#include "../Test/unit_test.h"
+#include <atomic>
+#include <cassert>
+#include <vector>
+
+using nostd::base_tree;
+
+class tree_test : public test_class {
+
+  void test() {
+    node_insert();
+    node_emplace();
+    preorder();
+    postorder();
+    parallel_traversals();
+  }
+
+  // a complete tree holding 1..n in heap order: the children of i are
+  // 2i and 2i + 1
+  typedef base_tree<int>::tree_node node;
+
+  std::vector<node*> build_tree(base_tree<int>& _tree, int _n) {
+    std::vector<node*> nodes(_n + 1, nullptr);
+    nodes[1] = _tree.add(_tree.root(), 1).node();
+    for(int i = 2; i <= _n; ++i)
+      nodes[i] = _tree.add(nodes[i / 2], i).node();
+    return nodes;
+  }
+
+  void expected_order(int _i, int _n, bool _pre, std::vector<int>& _order) {
+    if(_i > _n)
+      return;
+    if(_pre)
+      _order.push_back(_i);
+    expected_order(2 * _i, _n, _pre, _order);
+    expected_order(2 * _i + 1, _n, _pre, _order);
+    if(!_pre)
+      _order.push_back(_i);
+  }
+
+  void node_insert() {
+    base_tree<int> t;
+    auto n1 = t.add(t.root(), 1).node();
+    auto n2 = t.add(n1, 2).node();
+    auto n3 = t.add(n1, 3).node();
+
+    assert(t.size() == 3);
+    assert(n1->data() == 1 && n1->left() == n2 && n1->right() == n3);
+    assert(n2->parent() == n1 && n3->parent() == n1);
+    assert(t.begin().node() == n1);
+  }
+
+  void node_emplace() {
+    base_tree<std::pair<int, int>> t;
+    auto n = t.emplace(t.root(), 4, 5).node();
+    assert(t.size() == 1 && n->data().first == 4 && n->data().second == 5);
+  }
+
+  void preorder() {
+    base_tree<int> t;
+    build_tree(t, 100);
+    std::vector<int> order, expected;
+    t.preorder([&](int _x) { order.push_back(_x); });
+    expected_order(1, 100, true, expected);
+    assert(order == expected);
+  }
+
+  void postorder() {
+    base_tree<int> t;
+    build_tree(t, 100);
+    std::vector<int> order, expected;
+    t.postorder([&](int _x) { order.push_back(_x); });
+    expected_order(1, 100, false, expected);
+    assert(order == expected);
+  }
+
+  // with an executor the order across subtrees is free, but a parent still
+  // comes before (preorder) or after (postorder) its children
+  void parallel_traversals() {
+    const int n = 5000;
+    base_tree<int> t;
+    build_tree(t, n);
+    nostd::executor exec(4);
+
+    for(bool pre : {true, false}) {
+      std::vector<std::atomic<int>> seq(n + 1);
+      std::atomic<int> next{0};
+      auto visit = [&](int _x) { seq[_x] = next++; };
+      if(pre)
+        t.preorder(visit, &exec);
+      else
+        t.postorder(visit, &exec);
+
+      assert(next == n);
+      for(int i = 2; i <= n; ++i)
+        assert(pre ? seq[i / 2] < seq[i] : seq[i / 2] > seq[i]);
+    }
+  }
+
+  void benchmarks() {
+    const int n = 1 << 16;
+    base_tree<int> t;
+    build_tree(t, n);
+    nostd::executor exec(4);
+
+    long sum = 0;
+    auto& serial = benchmark("preorder", [&] {
+      t.preorder([&](int _x) { sum += _x; });
+    });
+    assert_msg(serial.allocations == 0, "preorder allocates");
+    do_not_optimize(sum);
+
+    std::atomic<long> total{0};
+    benchmark("preorder parallel", [&] {
+      t.preorder([&](int _x) { total.fetch_add(_x, std::memory_order_relaxed); }, &exec);
+    });
+  }
+};
+
+int main(int argc, char** argv) {
+  tree_test ttest;
+  return run_suite(ttest, argc, argv);
+}